@@ -0,0 +1,41 @@
+/*! \file */
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace cryptomath
+{
+/*! Contains primality functions which evaluate many 32-bit values at once.
+
+Each function works on arrays of lanes. Each lane is independent, so the same
+function can be used to test many witnesses against one modulus (by repeating the modulus)
+or one witness against many moduli (by repeating the witness). Work is handed to a vector
+kernel when the processor supports one, and to a scalar loop otherwise.
+*/
+namespace batch
+{
+
+//! Enum for the kernels which can evaluate the batch functions
+enum class Kernel{Scalar, AVX2};
+
+//! Number of lanes the vector kernels evaluate together
+const size_t LANES = 4;
+
+/*! \brief Finds the fastest kernel supported by the processor */
+Kernel bestKernel();
+
+/*! \brief Checks if the processor can run a kernel */
+bool supported(const Kernel& k);
+
+/*! \brief Computes \f$ a_i^{b_i} \f$ mod \f$ n_i \f$ for odd moduli */
+void powMod(const uint32_t* a, const uint32_t* b, const uint32_t* n, uint32_t* out, size_t count, Kernel k = bestKernel());
+
+/*! \brief Runs one Miller-Rabin round with witness \f$ a_i \f$ on each \f$ n_i \f$ */
+void millerRabin(const uint32_t* n, const uint32_t* a, uint8_t* out, size_t count, Kernel k = bestKernel());
+
+/*! \brief Deterministic primality test for 32-bit values */
+void isPrime(const uint32_t* n, uint8_t* out, size_t count, Kernel k = bestKernel());
+
+}
+}
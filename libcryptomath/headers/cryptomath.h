@@ -22,6 +22,13 @@ namespace cryptomath{}
 #include "./math_misc.h"
 #include "./math_modulararith.h"
 #include "./math_primality.h"
+#include "./math_continuedfractions.h"
+#include "./math_attacks.h"
+#include "./math_pell.h"
+#include "./batchprimality.h"
+
+#include "./fixed_uint.h"
+#include "./specializations_fixed.h"
 
 #ifdef CRYPTOMATH_GMP
 #include "./specializations_gmp.h"
@@ -0,0 +1,581 @@
+/*! \file */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cryptomath
+{
+
+/*! \brief Fixed-width unsigned integer
+
+An unsigned integer with a bit count known at compile time. The value is stored
+as an array of 64-bit limbs (least significant limb first) which lives inside the object,
+so no arithmetic on this type ever allocates memory. This makes it a good choice for
+the Integral type of the library when the size of the numbers is known ahead of time,
+and they are too large for the standard integer types.
+
+All arithmetic behaves like the standard unsigned types; results are reduced
+mod \f$ 2^{Bits} \f$ and negative values wrap around. The type supports all of the
+operators required by the library, and template specializations for the special-purpose
+functions can be found in specializations_fixed.h
+
+Values can be mixed freely with the standard integer types, which are converted implicitly.
+Conversion back to a standard integer type must be explicit, and keeps only the low bits.
+
+Template arguments
+    - uint64_t Bits - Number of bits in the type; must be a multiple of 64, and at least 128
+*/
+template<uint64_t Bits>
+class fixed_uint
+{
+    static_assert(Bits % 64 == 0 && Bits >= 128, "fixed_uint must have a multiple of 64 bits, and at least 128");
+
+    __extension__ typedef unsigned __int128 wide; /*!< Double-limb type used for carries and products */
+    __extension__ typedef __int128 swide; /*!< Signed double-limb type used for borrows */
+
+public:
+    //! Number of 64-bit limbs in the value
+    static constexpr uint64_t LIMBS = Bits / 64;
+
+    //! Type of the limb storage
+    typedef std::array<uint64_t, LIMBS> limb_array;
+
+private:
+    limb_array digits; /*!< Limbs of the value, least significant first */
+
+    /*! Finds the number of limbs in use, ignoring leading 0 limbs
+
+    \returns uint64_t - Index of the highest non-0 limb, plus one
+    */
+    uint64_t used() const
+    {
+        uint64_t n = LIMBS;
+        while(n > 0 && digits[n-1] == 0) n--;
+        return n;
+    }
+
+    /*! Divides by a single limb in place
+
+    \param[in] d The divisor
+    \returns uint64_t - The remainder
+    */
+    uint64_t divLimb(const uint64_t& d)
+    {
+        wide rem = 0;
+        for(uint64_t i = LIMBS; i-- > 0; )
+        {
+            wide cur = (rem << 64) | digits[i];
+            digits[i] = (uint64_t)(cur / d);
+            rem = cur % d;
+        }
+        return (uint64_t)rem;
+    }
+
+    /*! \brief Long division
+
+    Implements Knuth's Algorithm D (The Art of Computer Programming, Vol. 2, 4.3.1) with
+    64-bit digits. The divisor is normalized so that its top bit is set, which guarantees
+    that each estimated quotient digit is at most 2 too large.
+
+    \param[in] u The dividend
+    \param[in] v The divisor
+    \param[out] q The quotient
+    \param[out] r The remainder
+    \throws logic_error : v is 0
+    */
+    static void divmod(const fixed_uint& u, const fixed_uint& v, fixed_uint& q, fixed_uint& r)
+    {
+        const uint64_t n = v.used();
+        const uint64_t m = u.used();
+
+        if(n == 0)
+            throw std::logic_error("divide by 0");
+
+        if(u < v)
+        {
+            r = u;
+            q = 0;
+            return;
+        }
+
+        if(n == 1)
+        {
+            q = u;
+            r = q.divLimb(v.digits[0]);
+            return;
+        }
+
+        //Normalize so the top limb of the divisor has its high bit set
+        const unsigned s = __builtin_clzll(v.digits[n-1]);
+        std::array<uint64_t, LIMBS> vn;
+        std::array<uint64_t, LIMBS + 1> un;
+
+        for(uint64_t i = n-1; i > 0; i--)
+            vn[i] = (v.digits[i] << s) | (s ? v.digits[i-1] >> (64 - s) : 0);
+        vn[0] = v.digits[0] << s;
+
+        un[m] = s ? u.digits[m-1] >> (64 - s) : 0;
+        for(uint64_t i = m-1; i > 0; i--)
+            un[i] = (u.digits[i] << s) | (s ? u.digits[i-1] >> (64 - s) : 0);
+        un[0] = u.digits[0] << s;
+
+        q = 0;
+        for(uint64_t j = m - n + 1; j-- > 0; )
+        {
+            //Estimate the next quotient digit from the top two digits
+            wide num = ((wide)un[j+n] << 64) | un[j+n-1];
+            wide qhat = num / vn[n-1];
+            wide rhat = num - qhat * vn[n-1];
+
+            while((qhat >> 64) || qhat * vn[n-2] > ((rhat << 64) | un[j+n-2]))
+            {
+                qhat--;
+                rhat += vn[n-1];
+                if(rhat >> 64) break;
+            }
+
+            //Multiply and subtract
+            swide k = 0, t;
+            for(uint64_t i = 0; i < n; i++)
+            {
+                wide p = qhat * vn[i];
+                t = (swide)un[i+j] - k - (swide)(uint64_t)p;
+                un[i+j] = (uint64_t)t;
+                k = (swide)(p >> 64) - (t >> 64);
+            }
+            t = (swide)un[j+n] - k;
+            un[j+n] = (uint64_t)t;
+
+            //Estimate was one too large, add back
+            if(t < 0)
+            {
+                qhat--;
+                wide c = 0;
+                for(uint64_t i = 0; i < n; i++)
+                {
+                    c += (wide)un[i+j] + vn[i];
+                    un[i+j] = (uint64_t)c;
+                    c >>= 64;
+                }
+                un[j+n] += (uint64_t)c;
+            }
+            q.digits[j] = (uint64_t)qhat;
+        }
+
+        //Unnormalize the remainder
+        r = 0;
+        for(uint64_t i = 0; i < n; i++)
+            r.digits[i] = (un[i] >> s) | (s ? un[i+1] << (64 - s) : 0);
+    }
+
+public:
+    //! Constructs the value 0
+    fixed_uint() : digits() {}
+
+    /*! Constructs from a standard integer type
+
+    Negative values are sign-extended, so they wrap around the same way they
+    would for a standard unsigned type
+
+    \param[in] v The value
+    */
+    template<class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    fixed_uint(const T& v)
+    {
+        digits.fill(std::is_signed<T>::value && v < 0 ? ~(uint64_t)0 : 0);
+        digits[0] = (uint64_t)v;
+    }
+
+    /*! Constructs from a fixed_uint of a different size
+
+    The value is truncated if it does not fit
+
+    \param[in] v The value
+    */
+    template<uint64_t OtherBits>
+    explicit fixed_uint(const fixed_uint<OtherBits>& v) : digits()
+    {
+        for(uint64_t i = 0; i < LIMBS && i < fixed_uint<OtherBits>::LIMBS; i++)
+            digits[i] = v.limbs()[i];
+    }
+
+    /*! Constructs from a string of decimal digits
+
+    \param[in] s The decimal representation of the value
+    \throws domain_error : s contains something other than a digit
+    */
+    explicit fixed_uint(const std::string& s) : digits()
+    {
+        if(s.empty())
+            throw std::domain_error("fixed_uint requires at least one digit");
+
+        for(char c : s)
+        {
+            if(c < '0' || c > '9')
+                throw std::domain_error("fixed_uint can only be constructed from decimal digits");
+            *this = *this * 10 + (c - '0');
+        }
+    }
+
+    //! \returns limb_array - The limbs of the value, least significant first
+    const limb_array& limbs() const { return digits; }
+
+    //! \returns limb_array - The limbs of the value, least significant first
+    limb_array& limbs() { return digits; }
+
+    /*! \param[in] i Index of a bit, 0 being least significant
+        \returns uint8_t - The bit at index i
+    */
+    uint8_t bit(const uint64_t& i) const
+    {
+        return i < Bits ? (uint8_t)((digits[i / 64] >> (i % 64)) & 1) : 0;
+    }
+
+    //! \returns uint64_t - The number of bits needed to represent the value (0 for 0)
+    uint64_t bitlength() const
+    {
+        uint64_t n = used();
+        return n == 0 ? 0 : 64*n - __builtin_clzll(digits[n-1]);
+    }
+
+    //! \returns uint64_t - The number of 0 bits below the lowest set bit (Bits for 0)
+    uint64_t trailingZeros() const
+    {
+        for(uint64_t i = 0; i < LIMBS; i++)
+            if(digits[i]) return 64*i + __builtin_ctzll(digits[i]);
+        return Bits;
+    }
+
+    /*! Converts to a standard integer type, keeping only the low bits
+
+    \returns T - The value mod the size of T
+    */
+    template<class T, class = typename std::enable_if<std::is_integral<T>::value>::type>
+    explicit operator T() const
+    {
+        return std::is_same<T, bool>::value ? (T)(used() != 0) : (T)digits[0];
+    }
+
+    //! \returns string - The decimal representation of the value
+    std::string str() const
+    {
+        const uint64_t CHUNK = 10000000000000000000ull;
+
+        fixed_uint v = *this;
+        std::string out;
+        do
+        {
+            uint64_t part = v.divLimb(CHUNK);
+            bool last = v.used() == 0;
+            for(int i = 0; i < 19 && (!last || part); i++, part /= 10)
+                out.push_back('0' + part % 10);
+        }while(v.used());
+
+        if(out.empty()) out = "0";
+        std::reverse(out.begin(), out.end());
+        return out;
+    }
+
+    fixed_uint& operator +=(const fixed_uint& b)
+    {
+        wide c = 0;
+        for(uint64_t i = 0; i < LIMBS; i++)
+        {
+            c += (wide)digits[i] + b.digits[i];
+            digits[i] = (uint64_t)c;
+            c >>= 64;
+        }
+        return *this;
+    }
+
+    fixed_uint& operator -=(const fixed_uint& b)
+    {
+        uint64_t borrow = 0;
+        for(uint64_t i = 0; i < LIMBS; i++)
+        {
+            wide d = (wide)digits[i] - b.digits[i] - borrow;
+            digits[i] = (uint64_t)d;
+            borrow = (uint64_t)(d >> 64) & 1;
+        }
+        return *this;
+    }
+
+    fixed_uint& operator *=(const fixed_uint& b)
+    {
+        fixed_uint out;
+        const uint64_t na = used(), nb = b.used();
+        for(uint64_t i = 0; i < na; i++)
+        {
+            wide c = 0;
+            for(uint64_t j = 0; j < nb && i + j < LIMBS; j++)
+            {
+                c += (wide)digits[i] * b.digits[j] + out.digits[i+j];
+                out.digits[i+j] = (uint64_t)c;
+                c >>= 64;
+            }
+            if(i + nb < LIMBS) out.digits[i+nb] = (uint64_t)c;
+        }
+        return *this = out;
+    }
+
+    fixed_uint& operator /=(const fixed_uint& b)
+    {
+        fixed_uint r;
+        divmod(*this, b, *this, r);
+        return *this;
+    }
+
+    fixed_uint& operator %=(const fixed_uint& b)
+    {
+        fixed_uint q;
+        divmod(*this, b, q, *this);
+        return *this;
+    }
+
+    fixed_uint& operator &=(const fixed_uint& b)
+    {
+        for(uint64_t i = 0; i < LIMBS; i++) digits[i] &= b.digits[i];
+        return *this;
+    }
+
+    fixed_uint& operator |=(const fixed_uint& b)
+    {
+        for(uint64_t i = 0; i < LIMBS; i++) digits[i] |= b.digits[i];
+        return *this;
+    }
+
+    fixed_uint& operator ^=(const fixed_uint& b)
+    {
+        for(uint64_t i = 0; i < LIMBS; i++) digits[i] ^= b.digits[i];
+        return *this;
+    }
+
+    fixed_uint& operator <<=(const uint64_t& n)
+    {
+        const uint64_t limbs = n / 64, bits = n % 64;
+        for(uint64_t i = LIMBS; i-- > 0; )
+        {
+            uint64_t hi = i >= limbs ? digits[i - limbs] : 0;
+            uint64_t lo = i >= limbs + 1 ? digits[i - limbs - 1] : 0;
+            digits[i] = bits ? (hi << bits) | (lo >> (64 - bits)) : hi;
+        }
+        return *this;
+    }
+
+    fixed_uint& operator >>=(const uint64_t& n)
+    {
+        const uint64_t limbs = n / 64, bits = n % 64;
+        for(uint64_t i = 0; i < LIMBS; i++)
+        {
+            uint64_t lo = i + limbs < LIMBS ? digits[i + limbs] : 0;
+            uint64_t hi = i + limbs + 1 < LIMBS ? digits[i + limbs + 1] : 0;
+            digits[i] = bits ? (lo >> bits) | (hi << (64 - bits)) : lo;
+        }
+        return *this;
+    }
+
+    fixed_uint& operator ++() { return *this += 1; }
+    fixed_uint& operator --() { return *this -= 1; }
+    fixed_uint operator ++(int) { fixed_uint t = *this; *this += 1; return t; }
+    fixed_uint operator --(int) { fixed_uint t = *this; *this -= 1; return t; }
+
+    fixed_uint operator ~() const
+    {
+        fixed_uint out = *this;
+        for(uint64_t& d : out.digits) d = ~d;
+        return out;
+    }
+
+    fixed_uint operator -() const { return fixed_uint() - *this; }
+    fixed_uint operator +() const { return *this; }
+
+    friend fixed_uint operator +(fixed_uint a, const fixed_uint& b) { return a += b; }
+    friend fixed_uint operator -(fixed_uint a, const fixed_uint& b) { return a -= b; }
+    friend fixed_uint operator *(fixed_uint a, const fixed_uint& b) { return a *= b; }
+    friend fixed_uint operator /(fixed_uint a, const fixed_uint& b) { return a /= b; }
+    friend fixed_uint operator %(fixed_uint a, const fixed_uint& b) { return a %= b; }
+    friend fixed_uint operator &(fixed_uint a, const fixed_uint& b) { return a &= b; }
+    friend fixed_uint operator |(fixed_uint a, const fixed_uint& b) { return a |= b; }
+    friend fixed_uint operator ^(fixed_uint a, const fixed_uint& b) { return a ^= b; }
+    friend fixed_uint operator <<(fixed_uint a, const uint64_t& n) { return a <<= n; }
+    friend fixed_uint operator >>(fixed_uint a, const uint64_t& n) { return a >>= n; }
+
+    friend bool operator ==(const fixed_uint& a, const fixed_uint& b) { return a.digits == b.digits; }
+    friend bool operator !=(const fixed_uint& a, const fixed_uint& b) { return a.digits != b.digits; }
+    friend bool operator <(const fixed_uint& a, const fixed_uint& b)
+    {
+        for(uint64_t i = LIMBS; i-- > 0; )
+            if(a.digits[i] != b.digits[i]) return a.digits[i] < b.digits[i];
+        return false;
+    }
+    friend bool operator >(const fixed_uint& a, const fixed_uint& b) { return b < a; }
+    friend bool operator <=(const fixed_uint& a, const fixed_uint& b) { return !(b < a); }
+    friend bool operator >=(const fixed_uint& a, const fixed_uint& b) { return !(a < b); }
+
+    friend std::ostream& operator <<(std::ostream& out, const fixed_uint& a) { return out << a.str(); }
+};
+
+//! 128-bit unsigned integer
+typedef fixed_uint<128> uint128;
+
+//! 256-bit unsigned integer
+typedef fixed_uint<256> uint256;
+
+//! 512-bit unsigned integer
+typedef fixed_uint<512> uint512;
+
+//! 1024-bit unsigned integer
+typedef fixed_uint<1024> uint1024;
+
+/*! \brief Montgomery multiplication mod an odd number
+
+Montgomery multiplication replaces the division in \f$ ab \f$ mod \f$ n \f$ with
+multiplications and shifts. Values are moved into Montgomery form, \f$ aR \f$ mod \f$ n \f$
+where \f$ R = 2^{Bits} \f$. The product of two values in that form is reduced by adding
+the multiple of \f$ n \f$ which clears the low limbs, and then shifting them away. This is done one
+limb at a time, interleaved with the multiplication (the CIOS method), so no
+double-width intermediate is ever needed.
+
+Template arguments
+    - uint64_t Bits - Number of bits in the fixed_uint type
+*/
+template<uint64_t Bits>
+class montgomery
+{
+    typedef fixed_uint<Bits> value_type;
+    __extension__ typedef unsigned __int128 wide;
+    static constexpr uint64_t LIMBS = value_type::LIMBS;
+
+    value_type n; /*!< The modulus */
+    uint64_t ninv; /*!< \f$ -n^{-1} \f$ mod \f$ 2^{64} \f$ */
+    value_type r1; /*!< \f$ R \f$ mod \f$ n \f$ */
+    value_type r2; /*!< \f$ R^2 \f$ mod \f$ n \f$ */
+
+public:
+    /*! Sets up the constants for multiplication mod n
+
+    \param[in] n_ Some odd modulus
+    \throws domain_error : n is even
+    */
+    explicit montgomery(const value_type& n_) : n(n_)
+    {
+        if(n.bit(0) == 0)
+            throw std::domain_error("montgomery multiplication requires an odd modulus");
+
+        //Newton's iteration for the inverse mod 2^64, each
+        //step doubles the number of correct bits
+        uint64_t inv = n.limbs()[0];
+        for(int i = 0; i < 5; i++)
+            inv *= 2 - n.limbs()[0] * inv;
+        ninv = -inv;
+
+        //(2^Bits - n) mod n = 2^Bits mod n
+        r1 = (value_type() - n) % n;
+
+        //Double R another Bits times to get R^2
+        r2 = r1;
+        for(uint64_t i = 0; i < Bits; i++)
+        {
+            bool carry = r2.bit(Bits - 1);
+            r2 <<= 1;
+            if(carry || r2 >= n) r2 -= n;
+        }
+    }
+
+    /*! \param[in] a Some value in Montgomery form
+        \param[in] b Some value in Montgomery form
+        \returns fixed_uint - \f$ abR^{-1} \f$ mod \f$ n \f$
+    */
+    value_type multiply(const value_type& a, const value_type& b) const
+    {
+        std::array<uint64_t, LIMBS + 2> t = {};
+        const auto& A = a.limbs();
+        const auto& B = b.limbs();
+        const auto& N = n.limbs();
+
+        for(uint64_t i = 0; i < LIMBS; i++)
+        {
+            wide c = 0;
+            for(uint64_t j = 0; j < LIMBS; j++)
+            {
+                c += (wide)A[j] * B[i] + t[j];
+                t[j] = (uint64_t)c;
+                c >>= 64;
+            }
+            c += t[LIMBS];
+            t[LIMBS] = (uint64_t)c;
+            t[LIMBS+1] = (uint64_t)(c >> 64);
+
+            uint64_t m = t[0] * ninv;
+            c = ((wide)m * N[0] + t[0]) >> 64;
+            for(uint64_t j = 1; j < LIMBS; j++)
+            {
+                c += (wide)m * N[j] + t[j];
+                t[j-1] = (uint64_t)c;
+                c >>= 64;
+            }
+            c += t[LIMBS];
+            t[LIMBS-1] = (uint64_t)c;
+            t[LIMBS] = t[LIMBS+1] + (uint64_t)(c >> 64);
+        }
+
+        value_type out;
+        std::copy(t.begin(), t.begin() + LIMBS, out.limbs().begin());
+        if(t[LIMBS] || out >= n) out -= n;
+        return out;
+    }
+
+    //! \returns fixed_uint - a in Montgomery form
+    value_type to(const value_type& a) const { return multiply(a % n, r2); }
+
+    //! \returns fixed_uint - a out of Montgomery form
+    value_type from(const value_type& a) const { return multiply(a, 1); }
+
+    /*! \param[in] a
+        \param[in] b
+        \returns fixed_uint - \f$ a^b \f$ mod \f$ n \f$
+    */
+    value_type pow(const value_type& a, const value_type& b) const
+    {
+        value_type x = to(a);
+        value_type result = r1;
+
+        for(uint64_t i = b.bitlength(); i-- > 0; )
+        {
+            result = multiply(result, result);
+            if(b.bit(i)) result = multiply(result, x);
+        }
+        return from(result);
+    }
+};
+
+}
+
+namespace std
+{
+    //! Limits of the fixed_uint types, which behave like standard unsigned types
+    template<uint64_t Bits>
+    class numeric_limits<cryptomath::fixed_uint<Bits>>
+    {
+    public:
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = false;
+        static constexpr bool is_integer = true;
+        static constexpr bool is_exact = true;
+        static constexpr bool is_bounded = true;
+        static constexpr bool is_modulo = true;
+        static constexpr int digits = Bits;
+        static constexpr int radix = 2;
+
+        static cryptomath::fixed_uint<Bits> min() { return 0; }
+        static cryptomath::fixed_uint<Bits> lowest() { return 0; }
+        static cryptomath::fixed_uint<Bits> max() { return ~cryptomath::fixed_uint<Bits>(); }
+    };
+}
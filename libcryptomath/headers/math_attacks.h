@@ -0,0 +1,143 @@
+/*! \file */
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <iterator>
+#include <algorithm>
+
+#include "./math_misc.h"
+#include "./math_continuedfractions.h"
+
+#ifndef DBGOUT
+/*! Removes verbose debug outputs from compiled result */
+#define DBGOUT(a)
+#endif
+
+namespace cryptomath
+{
+
+/*! Contains attacks on RSA keys which use the number theory in the rest of the library */
+namespace attacks
+{
+
+/*! \brief Wiener's attack on RSA keys with a small private exponent
+
+If \f$ ed = 1 \f$ mod \f$ \phi(n) \f$, then \f$ ed - k\phi(n) = 1 \f$ for some \f$ k \f$, so \f$ k/d \f$ is very close to \f$ e/n \f$.
+When \f$ d < n^{1/4}/3 \f$ it is close enough that \f$ k/d \f$ is one of the convergents of the continued fraction of \f$ e/n \f$.
+
+Each convergent \f$ k/d \f$ is tested by computing \f$ \phi = (ed - 1)/k \f$, which must be an integer. Then
+\f$ s = n - \phi + 1 \f$ is \f$ p + q \f$, so \f$ (s/2)^2 - n = ((p - q)/2)^2 \f$ must be a perfect square. The continued
+fraction is streamed with fraction_expansion, and stops once \f$ d^2 > \sqrt{n} \f$, past the bound of the attack.
+
+Template arguments
+    - class Integral - Some integer type, which must be able to hold \f$ en \f$
+
+\param[in] e The public exponent
+\param[in] n The public modulus
+\returns Integral - The private exponent \f$ d \f$, or 0 if the key is not vulnerable
+*/
+template<class Integral>
+Integral wiener(const Integral& e, const Integral& n)
+{
+    DBGOUT("Wiener attack on " << e << ", " << n);
+
+    const Integral root = sqrtfloor<Integral>(n);
+    continuedfractions::fraction_expansion<Integral> expansion(e, n);
+    continuedfractions::convergents<Integral> approximations;
+
+    while(true)
+    {
+        approximations.push(expansion.term());
+        const Integral& k = approximations.p();
+        const Integral& d = approximations.q();
+
+        if(d * d > root) break;
+
+        if(k != 0)
+        {
+            Integral ed = e * d - 1;
+            if(ed % k == 0)
+            {
+                Integral phi = ed / k;
+                if(phi < n)
+                {
+                    Integral s = n - phi + 1;
+                    if(mod2<Integral>(s) == 0)
+                    {
+                        Integral half = s / 2;
+                        if(half * half >= n && intSqrt<Integral>(half * half - n).first)
+                        {
+                            DBGOUT("Found d = " << d);
+                            return d;
+                        }
+                    }
+                }
+            }
+        }
+
+        if(expansion.last()) break;
+        ++expansion;
+    }
+
+    return 0;
+}
+
+/*! \brief Runs Wiener's attack on many keys, across threads
+
+Each key is independent, so the keys are split across the workers and each worker runs wiener() on its share.
+Results are written in the same order as the keys.
+
+Template arguments
+    - class InputIt - Iterator over pair<Integral, Integral> holding \f$ (e, n) \f$
+    - class OutputIt - Iterator which accepts Integral
+
+\param[in] first Iterator to the first key
+\param[in] last Iterator past the last key
+\param[out] out Iterator to write the private exponent of each key to, or 0 if the key is not vulnerable
+\param[in] workers Number of threads to run (Default one per hardware core)
+\returns OutputIt - Iterator past the last result written
+*/
+template<class InputIt, class OutputIt>
+OutputIt wienerBatch(InputIt first, InputIt last, OutputIt out, uint64_t workers = std::thread::hardware_concurrency())
+{
+    typedef typename std::iterator_traits<InputIt>::value_type::first_type Integral;
+
+    std::vector<std::pair<Integral, Integral>> keys(first, last);
+    std::vector<Integral> results(keys.size(), Integral(0));
+    workers = std::max<uint64_t>(1, std::min<uint64_t>(workers, keys.size()));
+
+    DBGOUT("Wiener batch of " << keys.size() << " with " << workers << " workers");
+
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> threads;
+    for(uint64_t w = 0; w < workers; w++)
+    {
+        threads.emplace_back([&, w]()
+        {
+            try
+            {
+                for(size_t j = w; j < keys.size(); j += workers)
+                    results[j] = wiener<Integral>(keys[j].first, keys[j].second);
+            }
+            catch(...)
+            {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for(std::thread& t : threads)
+        t.join();
+
+    for(const std::exception_ptr& e : errors)
+        if(e) std::rethrow_exception(e);
+
+    for(const Integral& d : results)
+        *out++ = d;
+    return out;
+}
+
+}
+}
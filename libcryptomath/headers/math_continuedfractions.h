@@ -0,0 +1,358 @@
+/*! \file */
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+#include "./math_misc.h"
+
+#ifndef DBGOUT
+/*! Removes verbose debug outputs from compiled result */
+#define DBGOUT(a)
+#endif
+
+namespace cryptomath
+{
+namespace continuedfractions
+{
+
+/*! Holds a type without letting it be deduced from a function argument */
+template<class T>
+struct _nondeduced
+{
+    //! The held type
+    typedef T type;
+};
+
+/*! \brief Streams the continued fraction of a rational \f$ p/q \f$ one term at a time
+
+Each term is the quotient of one step of the Euclidian gcd, so the expansion is finite and
+exact for any Integral type. Callers which only need the first few terms, like the Wiener attack,
+can stop early instead of running the whole gcd.
+
+Template arguments
+    - class Integral - Some integer type
+*/
+template<class Integral>
+class fraction_expansion
+{
+public:
+    /*! \brief Starts the expansion of \f$ p/q \f$ at the integer part
+
+    \param[in] p The top of the rational to convert
+    \param[in] q The bottom of the rational to convert
+    \throws logic_error : q is 0
+    */
+    fraction_expansion(const Integral& p, const Integral& q) : _p(p), _q(q), _index(0)
+    {
+        if(_q == 0)
+            throw std::logic_error("divide by 0");
+
+        _a = _p / _q;
+        _p = _p % _q;
+    }
+
+    /*! \brief Moves to the next term of the expansion; does nothing after the last term
+    \returns fraction_expansion& - This expansion
+    */
+    fraction_expansion& operator++()
+    {
+        if(_p == 0) return *this;
+
+        Integral t = _p;
+        _p = _q;
+        _q = t;
+
+        _a = _p / _q;
+        _p = _p % _q;
+        _index++;
+
+        DBGOUT("fraction cf: " << _p << " / " << _q << " -- " << _a)
+        return *this;
+    }
+
+    //! \returns const Integral& - The current term
+    const Integral& term() const { return _a; }
+    //! \returns uint64_t - The index of the current term
+    uint64_t index() const { return _index; }
+    //! \returns bool - True if the current term is the last one
+    bool last() const { return _p == 0; }
+
+private:
+    Integral _p, _q, _a;
+    uint64_t _index;
+};
+
+/*! \brief Finds the continued fraction of a rational exactly
+
+The first value in the returned continued fraction is the integer portion, followed by the
+rest of the terms in order.
+
+The type is not deduced from the arguments, so ftocf(10, 8) gives a uint64_t result; other types must be named,
+as in ftocf<mpz_class>(e, n).
+
+Template arguments
+    - class Integral - Some integer type, uint64_t by default
+
+\param[in] p The top of the rational to convert
+\param[in] q The bottom of the rational to convert
+\returns vector<Integral> - The continued fraction, including the integer part
+\throws logic_error : q is 0
+*/
+template<class Integral = uint64_t>
+std::vector<Integral> ftocf(const typename _nondeduced<Integral>::type& p, const typename _nondeduced<Integral>::type& q)
+{
+    fraction_expansion<Integral> expansion(p, q);
+    std::vector<Integral> result{expansion.term()};
+
+    while(!expansion.last())
+        result.push_back((++expansion).term());
+
+    return result;
+}
+
+/*! \brief Streams the continued fraction of \f$ \sqrt{n} \f$ one term at a time
+
+The terms are generated exactly with the integer recurrence
+    - \f$ m(k+1) = d(k) a(k) - m(k) \f$
+    - \f$ d(k+1) = (n - m(k+1)^2) / d(k) \f$
+    - \f$ a(k+1) = \lfloor (a(0) + m(k+1)) / d(k+1) \rfloor \f$
+
+starting from \f$ m(0) = 0, d(0) = 1, a(0) = \lfloor \sqrt{n} \rfloor \f$. Every value stays below \f$ 2\sqrt{n} \f$,
+so the expansion can be continued for as long as needed without losing precision. The period ends on the first
+term where \f$ a(k) = 2a(0) \f$, and \f$ d(k) \f$ is the denominator of the complete quotient, which is
+the \f$ Q_k \f$ used in Pell's equation and CFRAC factoring.
+
+Perfect squares have only the integer part, so advancing past it leaves the expansion where it is.
+
+Template arguments
+    - class Integral - Some integer type
+*/
+template<class Integral>
+class sqrt_expansion
+{
+public:
+    /*! \brief Starts the expansion of \f$ \sqrt{n} \f$ at the integer part
+
+    sqrtfloor() may round for values which do not fit in a double, so the
+    integer part is corrected until it is exact.
+
+    \param[in] n The value to expand the square root of
+    */
+    explicit sqrt_expansion(const Integral& n) : _n(n), _a0(sqrtfloor<Integral>(n)), _m(0), _d(1), _index(0)
+    {
+        while(_a0 > 0 && _a0 > _n / _a0) _a0 = _a0 - 1;
+        while(_a0 + 1 <= _n / (_a0 + 1)) _a0 = _a0 + 1;
+        _a = _a0;
+        _square = _a0 * _a0 == _n;
+    }
+
+    /*! \brief Moves to the next term of the expansion
+    \returns sqrt_expansion& - This expansion
+    */
+    sqrt_expansion& operator++()
+    {
+        if(_square) return *this;
+
+        _m = _d * _a - _m;
+        _d = (_n - _m * _m) / _d;
+        _a = (_a0 + _m) / _d;
+        _index++;
+
+        DBGOUT("sqrt cf: m " << _m << " d " << _d << " a " << _a)
+        return *this;
+    }
+
+    //! \returns const Integral& - The current term \f$ a(k) \f$
+    const Integral& term() const { return _a; }
+    //! \returns const Integral& - The current \f$ m(k) \f$
+    const Integral& m() const { return _m; }
+    //! \returns const Integral& - The current \f$ d(k) \f$
+    const Integral& d() const { return _d; }
+    //! \returns const Integral& - The integer part \f$ a(0) \f$
+    const Integral& root() const { return _a0; }
+    //! \returns uint64_t - The index \f$ k \f$ of the current term
+    uint64_t index() const { return _index; }
+    //! \returns bool - True if n is a perfect square, so there are no terms after the integer part
+    bool square() const { return _square; }
+    //! \returns bool - True if the current term is the last one in the period
+    bool periodEnd() const { return _square || (_index > 0 && _a == _a0 + _a0); }
+
+private:
+    Integral _n, _a0, _m, _d, _a;
+    uint64_t _index;
+    bool _square;
+};
+
+/*! \brief Finds the continued fraction of \f$ \sqrt{n} \f$ exactly
+
+The first value in the returned continued fraction is the integer portion, and the remaning values
+repeat infinitely. The end of the period is the first value in the repeating fraction \f$ a \f$ such
+that \f$ a == 2i \f$. Perfect squares give only the integer portion.
+
+The type is not deduced from n, so sqrttocf(7) gives a uint64_t result; other types must be named,
+as in sqrttocf<mpz_class>(n).
+
+Template arguments
+    - class Integral - Some integer type, uint64_t by default
+
+\param[in] n The value to convert the square root of
+\returns vector<Integral> - The continued fraction, including the integer part. Everything except the integer part repeats infinitely
+*/
+template<class Integral = uint64_t>
+std::vector<Integral> sqrttocf(const typename _nondeduced<Integral>::type& n)
+{
+    sqrt_expansion<Integral> expansion(n);
+    std::vector<Integral> result{expansion.term()};
+
+    while(!expansion.periodEnd())
+        result.push_back((++expansion).term());
+
+    return result;
+}
+
+/*! \brief Builds the convergents \f$ p(k)/q(k) \f$ of a continued fraction one term at a time
+
+Each call to push() adds the next term and updates the convergent with
+    - \f$ p(k) = a(k) * p(k-1) + p(k-2) \f$
+    - \f$ q(k) = a(k) * q(k-1) + q(k-2) \f$
+
+where \f$ p(-2) = 0, p(-1) = 1, q(-2) = 1, q(-1) = 0 \f$. Only the last two convergents are kept, so any
+number of terms can be pushed. For types with a maximum value, a convergent which would not fit throws instead
+of wrapping around. Types without one, like mpz_class, are never checked.
+
+Template arguments
+    - class Integral - Some integer type
+*/
+template<class Integral>
+class convergents
+{
+public:
+    //! Starts with no terms
+    convergents() : _p0(0), _p1(1), _q0(1), _q1(0), _count(0) {}
+
+    /*! \brief Adds the next term of the continued fraction
+
+    \param[in] a The next term; every term after the first must be positive
+    \returns convergents& - This generator, with the convergent which ends at a
+    \throws overflow_error : The convergent does not fit in Integral
+    */
+    convergents& push(const Integral& a)
+    {
+        Integral p = _step(a, _p1, _p0);
+        Integral q = _step(a, _q1, _q0);
+
+        _p0 = _p1;
+        _p1 = p;
+        _q0 = _q1;
+        _q1 = q;
+        _count++;
+
+        DBGOUT("convergent " << _p1 << " / " << _q1)
+        return *this;
+    }
+
+    //! \returns const Integral& - The numerator \f$ p(k) \f$ of the current convergent
+    const Integral& p() const { return _p1; }
+    //! \returns const Integral& - The denominator \f$ q(k) \f$ of the current convergent
+    const Integral& q() const { return _q1; }
+    //! \returns pair<Integral, Integral> - The current convergent as \f$ (p(k), q(k)) \f$
+    std::pair<Integral, Integral> value() const { return std::pair<Integral, Integral>(_p1, _q1); }
+    //! \returns uint64_t - The number of terms pushed so far
+    uint64_t count() const { return _count; }
+
+private:
+    static Integral _step(const Integral& a, const Integral& x1, const Integral& x0)
+    {
+        if constexpr(std::numeric_limits<Integral>::is_bounded)
+        {
+            const Integral max = std::numeric_limits<Integral>::max();
+            if(a > 0 && x1 > 0 && (x1 > max / a || x0 > max - a*x1))
+                throw std::overflow_error("continued fraction convergent overflows the integer type");
+        }
+        return a*x1 + x0;
+    }
+
+    Integral _p0, _p1, _q0, _q1;
+    uint64_t _count;
+};
+
+/*! \brief Input iterator over the convergents of a sequence of continued fraction terms
+
+Dereferencing gives the convergent \f$ (p(k), q(k)) \f$ which ends at the current term. Convergents are
+computed as the iterator advances, so a caller can stop at the first one that satisfies it without computing
+the rest. Two iterators are equal when their term iterators are equal, so the end of the sequence is an iterator
+constructed with both arguments at the end of the terms.
+
+Template arguments
+    - class TermIterator - Iterator over the terms of the continued fraction
+    - class Integral - The type of the convergents, the value type of TermIterator by default
+
+\throws overflow_error : A convergent does not fit in Integral
+*/
+template<class TermIterator, class Integral = typename std::iterator_traits<TermIterator>::value_type>
+class convergent_iterator
+{
+public:
+    //! Convergents can be read once, in order
+    typedef std::input_iterator_tag iterator_category;
+    //! A convergent \f$ (p(k), q(k)) \f$
+    typedef std::pair<Integral, Integral> value_type;
+    //! Distance between iterators
+    typedef std::ptrdiff_t difference_type;
+    //! Pointer to a convergent
+    typedef const value_type* pointer;
+    //! Reference to a convergent
+    typedef const value_type& reference;
+
+    /*! \brief Starts at the convergent ending at term
+
+    \param[in] term The first term to use
+    \param[in] end The end of the terms
+    */
+    convergent_iterator(TermIterator term, TermIterator end) : _term(term), _end(end) { _load(); }
+
+    //! \returns reference - The current convergent
+    reference operator*() const { return _value; }
+    //! \returns pointer - The current convergent
+    pointer operator->() const { return &_value; }
+
+    //! \returns convergent_iterator& - This iterator, moved to the next convergent
+    convergent_iterator& operator++()
+    {
+        ++_term;
+        _load();
+        return *this;
+    }
+
+    //! \returns convergent_iterator - A copy of this iterator before it moved to the next convergent
+    convergent_iterator operator++(int)
+    {
+        convergent_iterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    //! \returns bool - True if both iterators are at the same term
+    bool operator==(const convergent_iterator& other) const { return _term == other._term; }
+    //! \returns bool - True if the iterators are at different terms
+    bool operator!=(const convergent_iterator& other) const { return _term != other._term; }
+
+private:
+    void _load()
+    {
+        if(_term != _end)
+            _value = _convergents.push(*_term).value();
+    }
+
+    TermIterator _term, _end;
+    convergents<Integral> _convergents;
+    value_type _value;
+};
+
+}
+}
@@ -3,14 +3,17 @@
 
 #include <utility>
 #include <vector>
-#include <functional>
 #include <queue>
-#include <algorithm>
 #include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 #include "./math_misc.h"
 #include "./math_primality.h"
 #include "./math_modulararith.h"
+#include "./math_continuedfractions.h"
 
 #ifndef DBGOUT
 /*! Removes verbose debug outputs from compiled result */
@@ -183,6 +186,37 @@ namespace factoring
         return mod<Integral>(x - 1, n);
     }
 
+    /*! \brief Runs one cycle of Pollard's Rho algorithm
+
+    Steps the sequences \f$ k_{i+1} = g(k_i) \f$ and \f$ k_{j+1} = g(g(k_j)) \f$ from some starting value
+    until the gcd of their difference and \f$ n \f$ is not 1. The step function is a template argument,
+    so it can be inlined into the loop.
+
+    Template arguments
+        - class Integral - Some Integer type
+        - G - The step function \f$ g(x) \f$ mod \f$ n \f$
+
+    \param[in] n The value to factor
+    \param[in] start The starting value of both sequences
+    \returns Integral - The gcd found, which is a factor of \f$ n \f$ unless it is 0 or \f$ n \f$
+    */
+    template <class Integral, Integral (*G)(const Integral&, const Integral&)>
+    Integral pollardrhoCycle(const Integral& n, const Integral& start)
+    {
+        Integral a = start;
+        Integral b = start;
+        Integral d = 1;
+        while(d == 1)
+        {
+            DBGOUT("a " << a);
+            a = G(a, n);
+            b = G(G(b, n), n);
+            d = gcd<Integral>(a-b, n);
+            DBGOUT(a << " " << b << " " << d);
+        }
+        return d;
+    }
+
     /*! Pollard's Rho algorithm for factoring
 
     Pollard's Rho algorithm makes use of the cyclical nature of polynomials mod some \f$ n \f$. Given some
@@ -212,30 +246,15 @@ namespace factoring
     template <class Integral>
     std::pair<Integral, Integral> pollardrho(const Integral& n)
     {
-        std::vector<std::function<Integral(const Integral&, const Integral&)>> PRhoFuncs {
-            pRho1<Integral>,
-            pRho2<Integral>};
-
         DBGOUT("Factor pollardrho " << n);
-        for(Integral a_ = 2; ; a_++)
+        for(Integral a = 2; ; a++)
         {
-            DBGOUT("a -> " << a_);
-            for(auto g : PRhoFuncs)
-            {
-                Integral b = a_;
-                Integral d = 1;
-                Integral a = a_;
-                while(d == 1)
-                {
-                    DBGOUT("a " << a);
-                    DBGOUT("g(a) " << g(a, n));                    
-                    a = g(a, n);
-                    b = g(g(b, n), n);
-                    d = gcd<Integral>(a-b, n);
-                    DBGOUT(a << " " << b << " " << d);
-                }
-                if(d != 0 && d != n) return std::pair<Integral, Integral>(d, n/d);
-            }
+            DBGOUT("a -> " << a);
+            Integral d = pollardrhoCycle<Integral, pRho1<Integral>>(n, a);
+            if(d != 0 && d != n) return std::pair<Integral, Integral>(d, n/d);
+
+            d = pollardrhoCycle<Integral, pRho2<Integral>>(n, a);
+            if(d != 0 && d != n) return std::pair<Integral, Integral>(d, n/d);
         }
     }
 
@@ -292,43 +311,280 @@ namespace factoring
             }while(gcd<Integral>(b_initial, n) != 1);
         }
     }
+
+    /*! \brief Finds subsets of exponent vectors which sum to 0 over GF(2)
+
+    Gaussian elimination on a bit matrix with one row per relation. Each row carries a history of
+    the relations which were added into it, so rows which are eliminated to 0 give the relations
+    whose product is a square.
+
+    \param[in] rows The exponent vectors mod 2, packed 64 columns per word
+    \param[in] columns The number of columns in each row
+    \returns vector<vector<size_t>> - The indices of the relations in each dependency
+    */
+    inline std::vector<std::vector<size_t>> _gf2Dependencies(std::vector<std::vector<uint64_t>> rows, size_t columns)
+    {
+        const size_t count = rows.size();
+        const size_t historyWords = (count + 63) / 64;
+
+        std::vector<std::vector<uint64_t>> history(count, std::vector<uint64_t>(historyWords, 0));
+        for(size_t r = 0; r < count; r++)
+            history[r][r / 64] |= uint64_t(1) << (r % 64);
+
+        std::vector<bool> pivot(count, false);
+        for(size_t c = 0; c < columns; c++)
+        {
+            const size_t word = c / 64;
+            const uint64_t bit = uint64_t(1) << (c % 64);
+
+            size_t p = 0;
+            while(p < count && (pivot[p] || !(rows[p][word] & bit))) p++;
+            if(p == count) continue;
+            pivot[p] = true;
+
+            for(size_t r = 0; r < count; r++)
+            {
+                if(r == p || !(rows[r][word] & bit)) continue;
+                for(size_t w = word; w < rows[r].size(); w++) rows[r][w] ^= rows[p][w];
+                for(size_t w = 0; w < historyWords; w++) history[r][w] ^= history[p][w];
+            }
+        }
+
+        //Every row which was not a pivot has been reduced to 0
+        std::vector<std::vector<size_t>> dependencies;
+        for(size_t r = 0; r < count; r++)
+        {
+            if(pivot[r]) continue;
+            dependencies.emplace_back();
+            for(size_t i = 0; i < count; i++)
+                if(history[r][i / 64] & (uint64_t(1) << (i % 64)))
+                    dependencies.back().push_back(i);
+        }
+        return dependencies;
+    }
+
+    /*! \brief Divides all primes in a factor base out of a value
+
+    This is the inner loop of cfrac(), so it avoids dividing by each prime with Integral. While the value
+    is larger than 63 bits, it is reduced mod a product of as many primes as fit in 64 bits, and the
+    primes are tested against that remainder. Once it fits in 63 bits the rest is done with native integers.
+
+    Template arguments
+        - class Integral - Some Integer type
+
+    \param[in] q The value to divide
+    \param[in] base The primes to divide by
+    \param[out] factors Pairs of (index in base + 1, exponent) for every prime which divides q
+    \returns Integral - q with every prime in the base divided out
+    */
+    template <class Integral>
+    Integral _divideBase(Integral q, const std::vector<uint64_t>& base, std::vector<std::pair<size_t, uint64_t>>& factors)
+    {
+        size_t j = 0;
+        while(j < base.size() && log2<Integral>(q) >= 63)
+        {
+            uint64_t product = 1;
+            size_t end = j;
+            while(end < base.size() && product <= std::numeric_limits<uint64_t>::max() / base[end])
+                product *= base[end++];
+
+            uint64_t r = toUint64<Integral>(q % Integral(product));
+            for(; j < end; j++)
+            {
+                if(r % base[j]) continue;
+
+                uint64_t e = 0;
+                for(; q % Integral(base[j]) == 0; e++) q = q / Integral(base[j]);
+                factors.emplace_back(j + 1, e);
+            }
+        }
+
+        if(log2<Integral>(q) >= 63) return q;
+
+        uint64_t small = toUint64<Integral>(q);
+        for(; j < base.size() && small > 1; j++)
+        {
+            uint64_t e = 0;
+            for(; small % base[j] == 0; e++) small /= base[j];
+            if(e) factors.emplace_back(j + 1, e);
+        }
+        return Integral(small);
+    }
+
+    /*! \brief Continued fraction (Morrison-Brillhart) factoring algorithm
+
+    The numerators \f$ A_i \f$ of the convergents of \f$ \sqrt{kn} \f$ satisfy \f$ A_{i-1}^2 = (-1)^i Q_i \f$ mod \f$ n \f$,
+    where \f$ Q_i < 2\sqrt{kn} \f$ is the denominator \f$ d(i) \f$ of the expansion. Since the \f$ Q_i \f$ are small, many
+    of them factor completely over a base of small primes. Once there are more of these relations than primes in the base,
+    a product of relations has even exponents on every prime, so \f$ x = \prod A_{i-1} \f$ and \f$ y = \sqrt{\prod (-1)^i Q_i} \f$
+    satisfy \f$ x^2 = y^2 \f$ mod \f$ n \f$, and \f$ gcd(x - y, n) \f$ is likely a factor, as in Shanks' square forms.
+
+    The factor base holds the primes below a bound \f$ B = e^{\sqrt{\ln n \ln \ln n}/2} \f$ for which \f$ kn \f$ is a quadratic
+    residue, since no other odd prime can divide a \f$ Q_i \f$. A \f$ Q_i \f$ which leaves a single prime below \f$ B^2 \f$ after
+    trial division is kept, and two of them with the same large prime are multiplied into one relation. The products are found
+    by Gaussian elimination over GF(2). If the expansion ends its period or every product is trivial, the multiplier \f$ k \f$
+    is increased.
+
+    Values with a factor below \f$ B \f$ are split by trial division, and squares are split directly. If no multiplier below 100
+    succeeds, which only happens for values too small to have a useful base, Pollard's rho algorithm is used instead.
+
+    Template arguments
+        - class Integral - Some Integer type, which must be able to hold \f$ 100n^2 \f$
+
+    \param[in] n The value to factor
+    \returns pair<Integral, Integral> - Two values with a product \f$ n \f$
+    */
+    template <class Integral>
+    std::pair<Integral, Integral> cfrac(const Integral& n)
+    {
+        DBGOUT("Factor cfrac " << n);
+
+        if(mod2<Integral>(n) == 0) return std::pair<Integral, Integral>(2, n/2);
+
+        auto sqt = intSqrt<Integral>(n);
+        if(sqt.first) return std::pair<Integral, Integral>(sqt.second, sqt.second);
+
+        //Size the factor base from ln(n)
+        const double lnN = (log2<Integral>(n) + 1) * std::log(2.0);
+        const uint64_t bound = std::max<uint64_t>(30, std::exp(std::sqrt(lnN * std::log(lnN)) / 2));
+        const Integral largeBound = Integral(bound) * Integral(bound);
+
+        std::vector<uint64_t> primes;
+        sundaramSieve<uint64_t>(bound, primes);
+        for(const uint64_t& p : primes)
+            if(n != Integral(p) && n % Integral(p) == 0)
+                return std::pair<Integral, Integral>(p, n / Integral(p));
+
+        for(uint64_t k = 1; k < 100; k++)
+        {
+            const Integral kn = n * Integral(k);
+
+            std::vector<uint64_t> base{2};
+            for(const uint64_t& p : primes)
+            {
+                uint64_t residue = toUint64<Integral>(kn % Integral(p));
+                if(p != 2 && (residue == 0 || powMod<uint64_t>(residue, (p-1)/2, p) == 1))
+                    base.push_back(p);
+            }
+            const size_t columns = base.size() + 1;
+            const size_t wanted = columns + 16;
+            DBGOUT("k = " << k << " base " << base.size() << " primes up to " << bound)
+
+            continuedfractions::sqrt_expansion<Integral> expansion(kn);
+            if(expansion.square()) continue;
+
+            //A relation is x = A(i-1) mod n, the factorization of (-1)^i Q(i) over the base with column 0 as the sign,
+            //and the large prime L when two partial relations were combined, so that (-1)^i Q(i) = L^2 * (base primes)
+            std::vector<Integral> x, large;
+            std::vector<std::vector<std::pair<size_t, uint64_t>>> exponents;
+
+            //Partial relations waiting for a second Q(i) with the same large prime
+            std::vector<Integral> partialX;
+            std::vector<std::vector<std::pair<size_t, uint64_t>>> partialExponents;
+            std::map<Integral, size_t> partials;
+
+            Integral A0 = 1, A1 = mod<Integral>(expansion.term(), n);
+            do
+            {
+                ++expansion;
+
+                std::vector<std::pair<size_t, uint64_t>> factors;
+                if(expansion.index() % 2 == 1) factors.emplace_back(0, 1);
+                Integral rest = _divideBase<Integral>(expansion.d(), base, factors);
+
+                if(rest == 1)
+                {
+                    x.push_back(A1);
+                    exponents.push_back(factors);
+                    large.push_back(1);
+                }
+                else if(rest < largeBound)
+                {
+                    auto match = partials.find(rest);
+                    if(match == partials.end())
+                    {
+                        partials[rest] = partialX.size();
+                        partialX.push_back(A1);
+                        partialExponents.push_back(factors);
+                    }
+                    else
+                    {
+                        x.push_back(mod<Integral>(A1 * partialX[match->second], n));
+                        for(const auto& f : partialExponents[match->second])
+                            factors.push_back(f);
+                        exponents.push_back(factors);
+                        large.push_back(rest);
+                    }
+                }
+
+                Integral A2 = mod<Integral>(expansion.term() * A1 + A0, n);
+                A0 = A1;
+                A1 = A2;
+            }while(x.size() < wanted && !expansion.periodEnd());
+
+            DBGOUT(x.size() << " relations after " << expansion.index() << " terms")
+
+            std::vector<std::vector<uint64_t>> rows;
+            for(const auto& factors : exponents)
+            {
+                rows.emplace_back((columns + 63) / 64, 0);
+                for(const auto& f : factors)
+                    if(f.second % 2) rows.back()[f.first / 64] ^= uint64_t(1) << (f.first % 64);
+            }
+
+            for(const std::vector<size_t>& dependency : _gf2Dependencies(rows, columns))
+            {
+                Integral X = 1, Y = 1;
+                std::vector<uint64_t> total(columns, 0);
+                for(const size_t& r : dependency)
+                {
+                    X = mod<Integral>(X * x[r], n);
+                    Y = mod<Integral>(Y * large[r], n);
+                    for(const auto& f : exponents[r])
+                        total[f.first] += f.second;
+                }
+
+                for(size_t j = 1; j < columns; j++)
+                    for(uint64_t e = 0; e < total[j] / 2; e++)
+                        Y = mod<Integral>(Y * Integral(base[j - 1]), n);
+
+                Integral f = gcd<Integral>(mod<Integral>(X + n - Y, n), n);
+                DBGOUT("x = " << X << " y = " << Y << " f = " << f)
+                if(f != 1 && f != n)
+                    return std::pair<Integral, Integral>(f, n/f);
+            }
+        }
+
+        return pollardrho<Integral>(n);
+    }
 }
 
 //! Enum containing all factoring methods available
-enum class Factor_Method{Fermat, PollardRho, Shanks, PollardP_1};
+enum class Factor_Method{Fermat, PollardRho, Shanks, PollardP_1, CFRAC};
 
-/*! \brief General factoring algorithm
+/*! \brief Factoring algorithm with the method chosen at compile time
 
 This function will use one of the specific factoring functions in the factoring namespace
 to find all prime factors of a number. It factors out all powers of 2, and checks for primality; 
 while factors are not prime, they are factored using the specified algorithm.
 
 Template arguments
+    - Factor_Method Method - The method of factorization to use
     - class Integral - Some Integer type
 
 \param[in] n The value to factor
-\param[in] m The method of factorization to use (Default Pollard's Rho algorithm)
 \returns vector<Integral, Integral> - All prime factors of \f$ n \f$ sorted from smallest to largest. 
     If \f$ n \f$ is prime, it contains only \f$ n \f$. 
     Factors which are used multiple times are included multiple times
 */
-template <class Integral>
-std::vector<Integral> factor(const Integral& n, const Factor_Method& m = Factor_Method::PollardRho)
+template <Factor_Method Method, class Integral>
+std::vector<Integral> factor(const Integral& n)
 {
-    DBGOUT("Factor " << n << " method " << (int)m);
-    const static std::map<Factor_Method, std::function<std::pair<Integral, Integral>(const Integral&)>> algos
-    {
-        {Factor_Method::Fermat, factoring::fermat<Integral>},
-        {Factor_Method::PollardRho, factoring::pollardrho<Integral>},
-        {Factor_Method::PollardP_1, factoring::pollardp1<Integral>},
-        {Factor_Method::Shanks, factoring::shanks<Integral>}
-    };
+    DBGOUT("Factor " << n << " method " << (int)Method);
 
     //Check if the number is 1 or 0
     if(n == 1 || n == 0) return std::vector<Integral>{n};
 
-    auto algo = algos.at(m);
-
     //Queue up n
     std::queue<Integral> composites;
     composites.push(n);
@@ -342,7 +598,7 @@ std::vector<Integral> factor(const Integral& n, const Factor_Method& m = Factor_
         DBGOUT("Check factor " << i);
 
         //Check the factor for primality
-        if(isPrime<Integral>(i))
+        if(isPrime<Primality_Test::MillerRabin, Integral>(i))
         {
             //If so, add to output
             DBGOUT("Is prime!");
@@ -361,7 +617,25 @@ std::vector<Integral> factor(const Integral& n, const Factor_Method& m = Factor_
         //Factor into two parts and add them to the list
         else if(i > 1)
         {
-            std::pair<Integral, Integral> factors = algo(i);
+            std::pair<Integral, Integral> factors;
+            switch(Method)
+            {
+                case Factor_Method::Fermat:
+                    factors = factoring::fermat<Integral>(i);
+                    break;
+                case Factor_Method::PollardRho:
+                    factors = factoring::pollardrho<Integral>(i);
+                    break;
+                case Factor_Method::Shanks:
+                    factors = factoring::shanks<Integral>(i);
+                    break;
+                case Factor_Method::PollardP_1:
+                    factors = factoring::pollardp1<Integral>(i);
+                    break;
+                case Factor_Method::CFRAC:
+                    factors = factoring::cfrac<Integral>(i);
+                    break;
+            }
             composites.push(factors.first);
             composites.push(factors.second);
             DBGOUT("Factored to " << factors.first << " " << factors.second);
@@ -373,6 +647,38 @@ std::vector<Integral> factor(const Integral& n, const Factor_Method& m = Factor_
     return out;
 }
 
+/*! \brief General factoring algorithm
+
+Finds all prime factors of a number with the specified method. See factor<Method>() for details;
+when the method is known at compile time, calling that directly avoids the switch on the method.
+
+Template arguments
+    - class Integral - Some Integer type
+
+\param[in] n The value to factor
+\param[in] m The method of factorization to use (Default Pollard's Rho algorithm)
+\returns vector<Integral, Integral> - All prime factors of \f$ n \f$ sorted from smallest to largest. 
+    If \f$ n \f$ is prime, it contains only \f$ n \f$. 
+    Factors which are used multiple times are included multiple times
+*/
+template <class Integral>
+std::vector<Integral> factor(const Integral& n, const Factor_Method& m = Factor_Method::PollardRho)
+{
+    switch(m)
+    {
+        case Factor_Method::Fermat:
+            return factor<Factor_Method::Fermat, Integral>(n);
+        case Factor_Method::Shanks:
+            return factor<Factor_Method::Shanks, Integral>(n);
+        case Factor_Method::PollardP_1:
+            return factor<Factor_Method::PollardP_1, Integral>(n);
+        case Factor_Method::CFRAC:
+            return factor<Factor_Method::CFRAC, Integral>(n);
+        default:
+            return factor<Factor_Method::PollardRho, Integral>(n);
+    }
+}
+
 /*! Calculates \f$ \phi(n) \f$
 
 This function calculates Euler's totient function for any value using
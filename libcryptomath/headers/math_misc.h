@@ -27,7 +27,7 @@ Template arguments
 \returns uint8_t - n % 2
 */
 template<class Integral>
-uint8_t mod2(const Integral& n)
+constexpr uint8_t mod2(const Integral& n)
 {
     return (uint8_t)(n & 1);
 }
@@ -56,7 +56,7 @@ Template arguments
 \returns Integral - a^b
 */
 template<class Integral>
-Integral powInt(const Integral& a, const Integral& b)
+constexpr Integral powInt(const Integral& a, const Integral& b)
 {
     if(b == 0) return 1;
     if(b == 1) return a;
@@ -93,11 +93,28 @@ Template arguments
 \returns bool - Whether or not Integral type has at least i bits
 */
 template<class Integral>
-bool hasBits(const uint64_t& i)
+constexpr bool hasBits(const uint64_t& i)
 {
     return sizeof(Integral)*8 >= i;
 }
 
+/*! \brief Converts a value to a 64-bit unsigned integer
+
+Used to hand values which are known to be small to functions which only
+work on standard types. Can be specialized for types which cannot be cast directly
+
+Template arguments
+    - class Integral - Some integer type
+
+\param[in] n Value to convert, which must fit in 64 bits
+\returns uint64_t - n as a uint64_t
+*/
+template<class Integral>
+constexpr uint64_t toUint64(const Integral& n)
+{
+    return static_cast<uint64_t>(n);
+}
+
 /*! \brief Absolute value
 
 Templated absolute value function which can be specialized
@@ -110,9 +127,8 @@ Template arguments
 \returns Integral - |a|
 */
 template<class Integral>
-Integral abs(const Integral& a){ 
-    using std::abs;
-    return abs(a);
+constexpr Integral abs(const Integral& a){ 
+    return a < 0 ? Integral(-a) : a;
 }
 
 /*! \brief Absolute value
@@ -125,7 +141,7 @@ unsigned values
 \returns uint64_t - |a|
 */
 template<>
-uint64_t inline abs<uint64_t>(const uint64_t& a){ return a; }
+constexpr uint64_t inline abs<uint64_t>(const uint64_t& a){ return a; }
 
 /*! \brief Absolute value
 
@@ -137,7 +153,7 @@ unsigned values
 \returns uint32_t - |a|
 */
 template<>
-uint32_t inline abs<uint32_t>(const uint32_t& a){ return a; }
+constexpr uint32_t inline abs<uint32_t>(const uint32_t& a){ return a; }
 
 /*! \brief Absolute value
 
@@ -149,7 +165,7 @@ unsigned values
 \returns uint8_t - |a|
 */
 template<>
-uint8_t inline abs<uint8_t>(const uint8_t& a){ return a; }
+constexpr uint8_t inline abs<uint8_t>(const uint8_t& a){ return a; }
 
 
 /*! \brief Checks if it is possible that a number is square
@@ -176,7 +192,7 @@ Template arguments
 \returns bool - Whether or not it's possible that n is square
 */
 template<class Integral>
-bool isMaybeSquare(const Integral& n)
+constexpr bool isMaybeSquare(const Integral& n)
 {
     Integral digs2 = n % 100;
     if(digs2 == 0 || digs2 == 25) return true;
@@ -26,7 +26,7 @@ namespace cryptomath
 \returns Integral - a (mod b)
 */
 template<class Integral>
-Integral mod(const Integral& a, const Integral& b)
+constexpr Integral mod(const Integral& a, const Integral& b)
 {
     if(b < 0) return -mod<Integral>(-a, -b);
     if(a < 0)
@@ -53,7 +53,7 @@ Template arguments
 \returns Integral - \f$ a^b\f$ mod \f$ n \f$
 */
 template<class Integral>
-Integral _powMod(Integral a, Integral b, const Integral& n) {
+constexpr Integral _powMod(Integral a, Integral b, const Integral& n) {
     if(n == 1) return 0;
 
     DBGOUT("powmod(" << a << ", " << b << ", " << n << ")");
@@ -73,9 +73,10 @@ Integral _powMod(Integral a, Integral b, const Integral& n) {
 
 /*! \brief PowMod wrapper to prevent overflow
 
-If n-1 is greater than the square root of the maximum value of Integral,
+If \f$ (n-1)^2 \f$ is greater than the maximum value of Integral,
 then the _powMod function will overflow the type. This wrapper throws an
-exception if that is the case. Specialize this template for any type which
+exception if that is the case. The check is done with one integer division,
+so it is exact and can be used in constant expressions. Specialize this template for any type which
 cannot be used with std::numeric_limits.
 
 Template arguments
@@ -88,9 +89,8 @@ Template arguments
 \throws logic_error : Computing the power mod n would overflow type Integral
 */
 template <class Integral>
-Integral powMod(const Integral& a, const Integral& b, const Integral& n) {
-    using std::sqrt;
-    if(n-1 > sqrt(std::numeric_limits<Integral>::max()))
+constexpr Integral powMod(const Integral& a, const Integral& b, const Integral& n) {
+    if(n > 1 && n-1 > std::numeric_limits<Integral>::max() / (n-1))
         throw std::logic_error("powmod integer overflow");
     return _powMod<Integral>(a, b, n);
 }
@@ -111,7 +111,7 @@ Template arguments
 \returns Integral - gcd(a, b)
 */
 template<class Integral>
-Integral _unsignedgcd(const Integral& a, const Integral& b)
+constexpr Integral _unsignedgcd(const Integral& a, const Integral& b)
 {
     //DBGOUT("GCD(" << a << ", " << b << ")")
     Integral modAb = a % b;
@@ -131,13 +131,13 @@ Template arguments
 \returns Integral - gcd(|a|, |b|)
 */
 template <class Integral>
-Integral gcd(Integral a, Integral b)
+constexpr Integral gcd(Integral a, Integral b)
 {
     //DBGOUT("GCD(" << a << ", " << b << ")")    
     //If a or b is negative, make them positive
     //and run unsigned gcd
-    a = abs(a);
-    b = abs(b);
+    a = abs<Integral>(a);
+    b = abs<Integral>(b);
     if(b == 0) return a;
     if(a == 0) return b;
 
@@ -162,10 +162,8 @@ Template arguments
 \returns array<Integral, 3> - [gcd(|a|, |b|), x, y]
 */
 template <class Integral>
-std::array<Integral, 3> extendedGcd(Integral a_, Integral b_)
+constexpr std::array<Integral, 3> extendedGcd(Integral a_, Integral b_)
 {
-    using std::swap;
-
     DBGOUT("Ext GCD(" << a_ << ", " << b_ << ")")
     
     bool a_neg = a_ < 0;
@@ -174,23 +172,23 @@ std::array<Integral, 3> extendedGcd(Integral a_, Integral b_)
     if(a_ == 0 && b_ == 0)
         return std::array<Integral, 3>{0, 0, 0};    
     if(a_ == 0)
-        return std::array<Integral, 3>{abs(b_), 0, abs(b_)/b_};
+        return std::array<Integral, 3>{abs<Integral>(b_), 0, abs<Integral>(b_)/b_};
     if(b_ == 0)
-        return std::array<Integral, 3>{abs(a_), abs(a_)/a_, 0};
+        return std::array<Integral, 3>{abs<Integral>(a_), abs<Integral>(a_)/a_, 0};
 
-    a_ = abs(a_);
-    b_ = abs(b_);
+    a_ = abs<Integral>(a_);
+    b_ = abs<Integral>(b_);
 
     bool swapped = false; //a_ < b_;
     //Swap a and b if b is greater
     Integral a = swapped ? b_ : a_;
     Integral b = swapped ? a_ : b_;
 
-    //xi and yi trackers
-    Integral x0 = 0, x1 = 1, xi;
-    Integral y0 = 1, y1 = 0, yi;
+    //xi and yi trackers; if b divides a, the solution is 0*a + 1*b
+    Integral x0 = 0, x1 = 1, xi = 1;
+    Integral y0 = 1, y1 = 0, yi = 0;
 
-    Integral q, modAb;
+    Integral q = 0, modAb = 0;
     while(a % b != 0)
     {
         modAb = a % b;
@@ -233,7 +231,7 @@ Template arguments
 \returns Integral - \f$ a^{-1} \f$ mod \f$ n \f$ (0 if non-existant)
 */
 template <class Integral>
-Integral inverseMod(const Integral& a, const Integral& n)
+constexpr Integral inverseMod(const Integral& a, const Integral& n)
 {
     DBGOUT("inverseMod(" << a << ", " << n << ")")
     std::array<Integral, 3> sln = extendedGcd<Integral>(a, n);
@@ -257,9 +255,9 @@ Template arguments
 \throws logic_error : powmod would overflow the Integral type
 */
 template<class Integral>
-Integral legendre(const Integral& a, const Integral& p)
+constexpr Integral legendre(const Integral& a, const Integral& p)
 {
-    return powMod<Integral>(a, (p-1)/2);
+    return powMod<Integral>(a, (p-1)/2, p);
 }
 
 /*! \brief Computes the jacobi symbol
@@ -280,10 +278,8 @@ Template arguments
 \throws logic_error : n is negative or even
 */
 template<class Integral>
-Integral _jacobi(Integral a, Integral n)
+constexpr Integral _jacobi(Integral a, Integral n)
 {
-    using std::swap;
-
     if(n <= 0 || mod2<Integral>(n) == 0)
         throw std::logic_error("jacobi of a negative or even base is undefined");
     
@@ -295,7 +291,7 @@ Integral _jacobi(Integral a, Integral n)
             j = -j;        
     }
 
-    Integral modded;
+    Integral modded = 0;
     while(a != 0)
     {
         while(mod<Integral>(a, 2) == 0)
@@ -307,7 +303,9 @@ Integral _jacobi(Integral a, Integral n)
                 j = -j;
         }
         // Quadratic reciprocity: Jacobi(a,b) = -Jacobi(b,a) if a=3,b=3 (mod 4)
-        swap(a, n);
+        Integral t = a;
+        a = n;
+        n = t;
 
         if(mod<Integral>(a, 4) == 3 && mod<Integral>(n, 4) == 3)
             j = -j;
@@ -334,7 +332,7 @@ Template arguments
 \throws logic_error : Integral is an unsigned type
 */
 template<class Integral>
-Integral jacobi(const Integral& a, const Integral& n)
+constexpr Integral jacobi(const Integral& a, const Integral& n)
 {
     if(std::is_unsigned<Integral>::value) 
         throw std::logic_error("jacobi calculation requires signed values");
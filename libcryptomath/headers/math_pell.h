@@ -0,0 +1,208 @@
+/*! \file */
+#pragma once
+
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+#include "./math_misc.h"
+#include "./math_continuedfractions.h"
+
+#ifndef DBGOUT
+/*! Removes verbose debug outputs from compiled result */
+#define DBGOUT(a)
+#endif
+
+namespace cryptomath
+{
+
+/*! \brief Computes \f$ ab + cd \f$, throwing if a bounded type would overflow
+
+Template arguments
+    - class Integral - Some non-negative integer type
+
+\param[in] a
+\param[in] b
+\param[in] c
+\param[in] d
+\returns Integral - \f$ ab + cd \f$
+\throws overflow_error : The result does not fit in Integral
+*/
+template<class Integral>
+Integral _checkedMulAdd(const Integral& a, const Integral& b, const Integral& c, const Integral& d)
+{
+    if constexpr(std::numeric_limits<Integral>::is_bounded)
+    {
+        const Integral max = std::numeric_limits<Integral>::max();
+        if((a != 0 && b > max / a) || (c != 0 && d > max / c) || a*b > max - c*d)
+            throw std::overflow_error("Pell solution overflows the integer type");
+    }
+    return a*b + c*d;
+}
+
+/*! \brief Finds the fundamental solution of Pell's equation \f$ x^2 - Dy^2 = \pm 1 \f$
+
+The fundamental solution is the convergent just before the end of the first period of the continued fraction
+of \f$ \sqrt{D} \f$. It is \f$ -1 \f$ when the period is odd and \f$ +1 \f$ when it is even.
+
+The period is symmetric, so only half of it is expanded, with the exact integer recurrence of sqrt_expansion. The middle
+is found when two consecutive \f$ m(k) \f$ are equal, for an even period, or two consecutive \f$ d(k) \f$ are equal,
+for an odd period. The solution is then built from the convergents \f$ A/B \f$ at the middle, where the period is \f$ 2h \f$ or \f$ 2h+1 \f$
+    - Even: \f$ x = (A_{h-1}^2 + DB_{h-1}^2)/d(h) \f$, \f$ y = 2A_{h-1}B_{h-1}/d(h) \f$
+    - Odd: \f$ x = (A_{h-1}A_h + DB_{h-1}B_h)/d(h) \f$, \f$ y = (A_{h-1}B_h + A_hB_{h-1})/d(h) \f$
+
+so the convergents never grow past the square root of the solution.
+
+Template arguments
+    - class Integral - Some integer type
+
+\param[in] D A positive value which is not a perfect square
+\returns pair<Integral, Integral> - \f$ (x, y) \f$, the smallest positive solution of \f$ x^2 - Dy^2 = \pm 1 \f$
+\throws domain_error : D is not positive, or is a perfect square
+\throws overflow_error : The solution does not fit in Integral
+*/
+template<class Integral>
+std::pair<Integral, Integral> solvePell(const Integral& D)
+{
+    DBGOUT("Solve Pell " << D);
+    if(D < 1)
+        throw std::domain_error("Pell's equation requires a positive D");
+
+    continuedfractions::sqrt_expansion<Integral> expansion(D);
+    if(expansion.square())
+        throw std::domain_error("Pell's equation has no solutions for a square D");
+
+    continuedfractions::convergents<Integral> approximations;
+    approximations.push(expansion.term());
+    Integral Ap = 1, Bp = 0;
+
+    while(true)
+    {
+        const Integral m = expansion.m(), d = expansion.d();
+        ++expansion;
+
+        //Only reached here for periods of 1 and 2
+        if(expansion.periodEnd())
+            return approximations.value();
+
+        const Integral& A = approximations.p();
+        const Integral& B = approximations.q();
+        if(expansion.m() == m)
+        {
+            DBGOUT("Even period " << 2*expansion.index() - 2)
+            const Integral DBp = _checkedMulAdd<Integral>(D, Bp, 0, 0);
+            return std::pair<Integral, Integral>(_checkedMulAdd<Integral>(Ap, Ap, DBp, Bp) / d,
+                                                 _checkedMulAdd<Integral>(Ap, Bp, Ap, Bp) / d);
+        }
+        if(expansion.d() == d)
+        {
+            DBGOUT("Odd period " << 2*expansion.index() - 1)
+            const Integral DBp = _checkedMulAdd<Integral>(D, Bp, 0, 0);
+            return std::pair<Integral, Integral>(_checkedMulAdd<Integral>(Ap, A, DBp, B) / d,
+                                                 _checkedMulAdd<Integral>(Ap, B, A, Bp) / d);
+        }
+
+        Ap = A;
+        Bp = B;
+        approximations.push(expansion.term());
+    }
+}
+
+/*! \brief Iterates through the solutions of Pell's equation \f$ x^2 - Dy^2 = \pm 1 \f$
+
+Every solution is a power of the fundamental solution \f$ x_1 + y_1\sqrt{D} \f$, so each solution is found by composing
+the last one with the fundamental solution
+    - \f$ x_{k+1} = x_1x_k + Dy_1y_k \f$
+    - \f$ y_{k+1} = x_1y_k + y_1x_k \f$
+
+rather than by expanding the continued fraction again. If the fundamental solution is a \f$ -1 \f$ solution, the solutions
+alternate between \f$ -1 \f$ and \f$ +1 \f$. The sequence never ends, so there is no end iterator.
+
+Template arguments
+    - class Integral - Some integer type
+*/
+template<class Integral>
+class pell_iterator
+{
+public:
+    //! Solutions can be read once, in order
+    typedef std::input_iterator_tag iterator_category;
+    //! A solution \f$ (x, y) \f$
+    typedef std::pair<Integral, Integral> value_type;
+    //! Distance between iterators
+    typedef std::ptrdiff_t difference_type;
+    //! Pointer to a solution
+    typedef const value_type* pointer;
+    //! Reference to a solution
+    typedef const value_type& reference;
+
+    /*! \brief Starts at the fundamental solution for D
+
+    \param[in] D A positive value which is not a perfect square
+    \throws domain_error : D is not positive, or is a perfect square
+    */
+    explicit pell_iterator(const Integral& D) : pell_iterator(D, solvePell<Integral>(D)) {}
+
+    /*! \brief Starts at a known fundamental solution
+
+    \param[in] D A positive value which is not a perfect square
+    \param[in] fundamental The fundamental solution from solvePell()
+    */
+    pell_iterator(const Integral& D, const value_type& fundamental) : _D(D), _fundamental(fundamental), _current(fundamental), _power(1)
+    {
+        //The norm is found mod 3, where -1 is 2, so squaring the solution cannot overflow
+        Integral x = fundamental.first % 3, y = fundamental.second % 3;
+        _negative = (x*x + 2*(D % 3)*y*y) % 3 == 2;
+    }
+
+    //! \returns reference - The current solution
+    reference operator*() const { return _current; }
+    //! \returns pointer - The current solution
+    pointer operator->() const { return &_current; }
+
+    /*! \brief Moves to the next power of the fundamental solution
+    \returns pell_iterator& - This iterator
+    \throws overflow_error : The solution does not fit in Integral
+    */
+    pell_iterator& operator++()
+    {
+        const Integral& x1 = _fundamental.first;
+        const Integral& y1 = _fundamental.second;
+        Integral x = _checkedMulAdd<Integral>(x1, _current.first, _checkedMulAdd<Integral>(_D, y1, 0, 0), _current.second);
+        Integral y = _checkedMulAdd<Integral>(x1, _current.second, y1, _current.first);
+
+        _current = value_type(x, y);
+        _power++;
+
+        DBGOUT("Pell solution " << _power << ": " << x << ", " << y)
+        return *this;
+    }
+
+    //! \returns pell_iterator - A copy of this iterator before it moved to the next solution
+    pell_iterator operator++(int)
+    {
+        pell_iterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    //! \returns uint64_t - The power of the fundamental solution which gives the current solution
+    uint64_t power() const { return _power; }
+    //! \returns int - The value of \f$ x^2 - Dy^2 \f$ for the current solution, 1 or -1
+    int norm() const { return _negative && _power % 2 == 1 ? -1 : 1; }
+
+    //! \returns bool - True if both iterators are at the same power of the same solution
+    bool operator==(const pell_iterator& other) const { return _D == other._D && _power == other._power; }
+    //! \returns bool - True if the iterators are at different solutions
+    bool operator!=(const pell_iterator& other) const { return !(*this == other); }
+
+private:
+    Integral _D;
+    value_type _fundamental, _current;
+    uint64_t _power;
+    bool _negative;
+};
+
+}
@@ -3,12 +3,19 @@
 
 #include <random>
 #include <utility>
-#include <map>
-#include <functional>
-#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <array>
+#include <memory>
+#include <type_traits>
 
 #include "./math_misc.h"
 #include "./math_modulararith.h"
+#include "./batchprimality.h"
 
 #ifndef DBGOUT
 /*! Removes verbose debug outputs from compiled result */
@@ -18,10 +25,36 @@
 namespace cryptomath
 {
 
-/*! \brief Factors all powers of 2 out of a number
+/*! \brief Random engine used by the probabilistic tests when no generator is given
 
-Many factoring and primality tests only work with odd integers. This
-function divides all powers of two out of a number
+Each thread has its own engine, so the tests can be run from many threads without locking,
+and the engine is only seeded once per thread instead of once per test. It is initially seeded
+from std::random_device
+
+\returns mt19937_64& - The calling thread's engine
+*/
+inline std::mt19937_64& defaultEngine()
+{
+    thread_local std::mt19937_64 engine(std::random_device{}());
+    return engine;
+}
+
+/*! \brief Reseeds the calling thread's default engine
+
+Makes the probabilistic tests run without an explicit generator reproducible
+
+\param[in] seed - The new seed
+*/
+inline void seedDefaultEngine(const uint64_t& seed)
+{
+    defaultEngine().seed(seed);
+}
+
+/*! \brief Factors all powers of 2 out of a number, using only arithmetic operators
+
+Used by factor2s() for types which are not native integers. The largest power of
+2 which could divide the number is found, and then smaller and smaller powers are
+divided out
 
 Template arguments
     - class Integral - Some integer type
@@ -30,11 +63,8 @@ Template arguments
 \returns pair<Integral, Integral> - [number of 2's factored out, n with all powers of 2 factored out]
 */
 template<class Integral>
-std::pair<Integral, Integral> factor2s(const Integral& n)
+std::pair<Integral, Integral> _factor2s(const Integral& n, std::false_type)
 {
-    DBGOUT("Factor 2's " << n);
-    if(n == 0) return std::make_pair(Integral(0), Integral(0));
-    
     Integral lg2(log2<Integral>(n));
     Integral fac = powInt<Integral>(2, lg2);
     
@@ -50,11 +80,53 @@ std::pair<Integral, Integral> factor2s(const Integral& n)
         fac = fac / 2;
         lg2 = lg2 - 1;
     }
-    
-    DBGOUT(r << ", " << d);
     return std::make_pair(r, d);
 }
 
+/*! \brief Factors all powers of 2 out of a native integer
+
+Used by factor2s() for native integer types. The number of 2's is the number of trailing
+zero bits, so the whole factorization is one bit scan and one shift
+
+Template arguments
+    - class Integral - Some native integer type, no more than 64 bits
+
+\param[in] n - The number to factor 2's from, which is not 0
+\returns pair<Integral, Integral> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<class Integral>
+std::pair<Integral, Integral> _factor2s(const Integral& n, std::true_type)
+{
+    int r = __builtin_ctzll((unsigned long long)n);
+    return std::make_pair(Integral(r), Integral(n >> r));
+}
+
+/*! \brief Factors all powers of 2 out of a number
+
+Many factoring and primality tests only work with odd integers. This
+function divides all powers of two out of a number
+
+Native integers are handled with a bit scan; other types can specialize
+this function if they have a faster method than repeated division
+
+Template arguments
+    - class Integral - Some integer type
+
+\param[in] n - The number to factor 2's from 
+\returns pair<Integral, Integral> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<class Integral>
+std::pair<Integral, Integral> factor2s(const Integral& n)
+{
+    DBGOUT("Factor 2's " << n);
+    if(n == 0) return std::make_pair(Integral(0), Integral(0));
+    
+    std::pair<Integral, Integral> result = _factor2s<Integral>(n, typename std::is_integral<Integral>::type());
+
+    DBGOUT(result.first << ", " << result.second);
+    return result;
+}
+
 /*! \brief Sundaram's sieve for finding prime numbers
 
 The sieve of Sundaram finds all the prime numbers less than some \f$ n \f$.
@@ -86,6 +158,62 @@ void sundaramSieve(const Integral& n, std::vector<Integral>& result)
             result.push_back(2*i + 1);
 }
 
+/*! \brief Sieve of Eratosthenes at compile time
+
+Template arguments
+    - uint64_t Limit - Number of values to sieve
+
+\returns array<bool, Limit> - true for every index which is composite (0 and 1 are not marked)
+*/
+template<uint64_t Limit>
+constexpr std::array<bool, Limit> _compositeTable()
+{
+    std::array<bool, Limit> composite{};
+    for(uint64_t i = 2; i * i < Limit; i++)
+        if(!composite[i])
+            for(uint64_t j = i * i; j < Limit; j += i)
+                composite[j] = true;
+    return composite;
+}
+
+/*! \brief Counts the primes less than some limit at compile time
+
+Template arguments
+    - uint64_t Limit - Number to count primes less than
+
+\returns uint64_t - Number of primes less than Limit
+*/
+template<uint64_t Limit>
+constexpr uint64_t _primeCount()
+{
+    std::array<bool, Limit> composite = _compositeTable<Limit>();
+    uint64_t count = 0;
+    for(uint64_t i = 2; i < Limit; i++)
+        if(!composite[i]) count++;
+    return count;
+}
+
+/*! \brief Table of all primes less than some limit, which can be built at compile time
+
+Used for trial division by small primes. Declaring the result constexpr means the table
+is built by the compiler, instead of with sundaramSieve() at startup
+
+Template arguments
+    - uint64_t Limit - Number to find primes less than
+
+\returns array<uint64_t> - All primes less than Limit, in order
+*/
+template<uint64_t Limit>
+constexpr std::array<uint64_t, _primeCount<Limit>()> primeTable()
+{
+    std::array<bool, Limit> composite = _compositeTable<Limit>();
+    std::array<uint64_t, _primeCount<Limit>()> primes{};
+    uint64_t k = 0;
+    for(uint64_t i = 2; i < Limit; i++)
+        if(!composite[i]) primes[k++] = i;
+    return primes;
+}
+
 //! Contains specific primality tests
 namespace primality
 {
@@ -105,17 +233,17 @@ namespace primality
 
     Template arguments
         - class Integral - Some integer type
+        - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
 
     \param[in] n - The number to test for primality
-    \param[in] iterations - The number of witness values to test (Default 10)
+    \param[in] iterations - The number of witness values to test
+    \param[in, out] bits - A random bit generator to pick witnesses with
     \return bool - Whether or not \f$ n \f$ is probably prime
     */
-    template<class Integral>
-    bool millerRabin(const Integral& n, const uint64_t& iterations = 10)
+    template<class Integral, class UniformRandomBitGenerator>
+    bool millerRabin(const Integral& n, const uint64_t& iterations, UniformRandomBitGenerator& bits)
     {
         DBGOUT("MillerRabin(" << n << ")");
-        auto t = std::chrono::system_clock::now();
-        std::mt19937_64 reng(std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count());
         std::uniform_int_distribution<uint64_t> dist(2);
 
         std::pair<Integral, Integral> rd = factor2s<Integral>(n-1);
@@ -126,7 +254,7 @@ namespace primality
         for(int i=0; i<iterations; i++)
         {
             //Get a random number
-            uint64_t a_ = dist(reng);
+            uint64_t a_ = dist(bits);
 
             //Make sure it is between 2 and n-2
             Integral a = mod<Integral>(Integral(a_), n-4) + 2;
@@ -162,6 +290,24 @@ namespace primality
         return true;
     }
 
+    /*! \brief Miller-Rabin primality test using the default engine
+
+    See millerRabin(const Integral&, const uint64_t&, UniformRandomBitGenerator&); witnesses
+    are picked with the calling thread's defaultEngine()
+
+    Template arguments
+        - class Integral - Some integer type
+
+    \param[in] n - The number to test for primality
+    \param[in] iterations - The number of witness values to test (Default 10)
+    \return bool - Whether or not \f$ n \f$ is probably prime
+    */
+    template<class Integral>
+    bool millerRabin(const Integral& n, const uint64_t& iterations = 10)
+    {
+        return millerRabin<Integral>(n, iterations, defaultEngine());
+    }
+
     /*! \brief Implementation of the Solovay-Strassen primality test
 
     Euler's legendre symbol can be calculated as \f$ (\frac{a}{p}) = a^{(p-1)/2} \f$ for all \f$ p \f$ prime.
@@ -178,24 +324,25 @@ namespace primality
 
     Template arguments
         - class Integral - Some integer type
+        - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
 
     \param[in] n - The number to test for primality
-    \param[in] iterations - The number of witness values to test (Default 10)
+    \param[in] iterations - The number of witness values to test
+    \param[in, out] bits - A random bit generator to pick witnesses with
     \return bool - Whether or not \f$ n \f$ is probably prime
     */
-    template<class Integral>
-    bool solovayStrassen(const Integral& n, const uint64_t& iterations=10)
+    template<class Integral, class UniformRandomBitGenerator>
+    bool solovayStrassen(const Integral& n, const uint64_t& iterations, UniformRandomBitGenerator& bits)
     {
         DBGOUT("SolovayStrassen(" << n << ")");
         
-        std::mt19937_64 reng;
         std::uniform_int_distribution<uint64_t> dist(2);
 
         Integral n12 = (n-1)/2;
 
         for(uint64_t i = 0; i < iterations; i++)
         {
-            Integral a_ = dist(reng);
+            Integral a_ = dist(bits);
             Integral a = mod<Integral>(Integral(a_), n-4) + 2;
 
             DBGOUT("Jacobi(" << a << ", " << n << ") = " << jacobi<Integral>(a, n));
@@ -205,16 +352,97 @@ namespace primality
         }
         return true;
     }
+
+    /*! \brief Solovay-Strassen primality test using the default engine
+
+    See solovayStrassen(const Integral&, const uint64_t&, UniformRandomBitGenerator&); witnesses
+    are picked with the calling thread's defaultEngine()
+
+    Template arguments
+        - class Integral - Some integer type
+
+    \param[in] n - The number to test for primality
+    \param[in] iterations - The number of witness values to test (Default 10)
+    \return bool - Whether or not \f$ n \f$ is probably prime
+    */
+    template<class Integral>
+    bool solovayStrassen(const Integral& n, const uint64_t& iterations = 10)
+    {
+        return solovayStrassen<Integral>(n, iterations, defaultEngine());
+    }
 }
 
 //! Enum for available primality tests
 enum class Primality_Test{MillerRabin, SolovayStrassen};
 
+/*! \brief Prime test with the test chosen at compile time
+
+Checks a couple of trivial cases first; anything less than 3 or even is hard-coded. The rest is passed
+straight to the test in the primality namespace, so the call can be inlined.
+
+Template arguments
+    - Primality_Test Test - Which primality test to use
+    - class Integral - Some integer type
+
+\param[in] n The number to test for primality
+\param[in] iterations Number of iterations to do the probabalistic test
+\return bool - Whether or not \f$ n \f$ is probably prime
+*/
+template<Primality_Test Test, class Integral>
+bool isPrime(const Integral& n, const uint64_t& iterations = 20)
+{
+    if(n == 2 || n == 3) return true;
+    if(n < 3 || mod2<Integral>(n) == 0) return false;
+
+    switch(Test)
+    {
+        case Primality_Test::MillerRabin:
+            return primality::millerRabin<Integral>(n, iterations);
+        case Primality_Test::SolovayStrassen:
+            return primality::solovayStrassen<Integral>(n, iterations);
+    }
+    return false;
+}
+
+/*! \brief Prime test with the test chosen at compile time, using a given generator
+
+See isPrime<Test>(const Integral&, const uint64_t&). Witnesses are picked with bits, so a fixed seed
+gives the same result every run. This always uses the templated tests in the primality namespace, even for types
+which specialize them to use a native test
+
+Template arguments
+    - Primality_Test Test - Which primality test to use
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
+
+\param[in] n The number to test for primality
+\param[in] iterations Number of iterations to do the probabalistic test
+\param[in, out] bits A random bit generator to pick witnesses with
+\return bool - Whether or not \f$ n \f$ is probably prime
+*/
+template<Primality_Test Test, class Integral, class UniformRandomBitGenerator>
+bool isPrime(const Integral& n, const uint64_t& iterations, UniformRandomBitGenerator& bits)
+{
+    if(n == 2 || n == 3) return true;
+    if(n < 3 || mod2<Integral>(n) == 0) return false;
+
+    switch(Test)
+    {
+        case Primality_Test::MillerRabin:
+            return primality::millerRabin<Integral>(n, iterations, bits);
+        case Primality_Test::SolovayStrassen:
+            return primality::solovayStrassen<Integral>(n, iterations, bits);
+    }
+    return false;
+}
+
 /*! General prime test
 
 This prime test function uses one of the prime tests in the primality namespace to check if a number is prime. A couple of trivial cases
 are checked for first; anything less than 3 or even is hard-coded.
 
+When the test is known at compile time, isPrime<Test>() avoids the switch on the test.
+
 Template arguments
     - class Integral - Some integer type
 
@@ -226,16 +454,158 @@ Template arguments
 template<class Integral>
 bool isPrime(const Integral& n, const Primality_Test& test = Primality_Test::MillerRabin, const uint64_t& iterations = 20)
 {
-    const static std::map<Primality_Test, std::function<bool(const Integral&, const uint64_t&)>> algos
+    switch(test)
     {
-        {Primality_Test::MillerRabin, primality::millerRabin<Integral>},
-        {Primality_Test::SolovayStrassen, primality::solovayStrassen<Integral>}        
-    };
+        case Primality_Test::SolovayStrassen:
+            return isPrime<Primality_Test::SolovayStrassen, Integral>(n, iterations);
+        default:
+            return isPrime<Primality_Test::MillerRabin, Integral>(n, iterations);
+    }
+}
 
-    if(n == 2 || n == 3) return true;
-    if(n < 3 || mod2<Integral>(n) == 0) return false;
+/*! General prime test, using a given generator
+
+See isPrime(const Integral&, const Primality_Test&, const uint64_t&). Witnesses are picked with bits,
+so a fixed seed gives the same result every run
+
+Template arguments
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
 
-    return algos.at(test)(n, iterations);
+\param[in] n The number to test for primality
+\param[in] test Which primality test to use
+\param[in] iterations Number of iterations to do the probabalistic test
+\param[in, out] bits A random bit generator to pick witnesses with
+\return bool - Whether or not \f$ n \f$ is probably prime
+*/
+template<class Integral, class UniformRandomBitGenerator>
+bool isPrime(const Integral& n, const Primality_Test& test, const uint64_t& iterations, UniformRandomBitGenerator& bits)
+{
+    switch(test)
+    {
+        case Primality_Test::SolovayStrassen:
+            return isPrime<Primality_Test::SolovayStrassen, Integral>(n, iterations, bits);
+        default:
+            return isPrime<Primality_Test::MillerRabin, Integral>(n, iterations, bits);
+    }
+}
+
+//! Enum for the ways a batch of primality tests can be evaluated
+enum class Batch_Policy{Serial, Threaded, SIMD};
+
+/*! \brief Tests a whole range of values for primality
+
+Testing many candidates with isPrime() one at a time repeats the same setup for every value. This
+function first trial divides every value by the primes below 256, which settles most composites and
+all values below \f$ 256^2 \f$ without any exponentiation. The remaining values are tested according to the policy
+
+    - Serial: isPrime() is called on each value in turn
+    - Threaded: The values are split between one thread per hardware core, each calling isPrime()
+    - SIMD: Values which fit in 32 bits are tested exactly by batch::isPrime(), using the vector kernel when available. Larger values are tested serially
+
+Template arguments
+    - class InputIt - Some input iterator to an integer type
+    - class OutputIt - Some output iterator accepting bool
+
+\param[in] first Start of the values to test
+\param[in] last End of the values to test
+\param[out] out Start of the result bitmap. Whether or not each value is probably prime is written in order
+\param[in] policy How to evaluate the batch (Default Serial)
+\param[in] test Which primality test to use for values not settled by trial division
+\param[in] iterations Number of iterations to do the probabalistic test
+\returns OutputIt - Iterator past the last result written
+*/
+template<class InputIt, class OutputIt>
+OutputIt isPrimeBatch(InputIt first, InputIt last, OutputIt out, const Batch_Policy& policy = Batch_Policy::Serial,
+                      const Primality_Test& test = Primality_Test::MillerRabin, const uint64_t& iterations = 20)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type Integral;
+    constexpr uint64_t SIEVE_LIMIT = 256;
+    static constexpr auto smallPrimes = primeTable<SIEVE_LIMIT>();
+
+    std::vector<Integral> values(first, last);
+    std::vector<uint8_t> results(values.size(), 0);
+    std::vector<size_t> remaining;
+
+    //Trial division settles small values and values with small factors
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        const Integral& n = values[i];
+        if(n < 2) continue;
+
+        bool settled = false;
+        for(const uint64_t& p : smallPrimes)
+        {
+            if(n == Integral(p))
+            {
+                results[i] = 1;
+                settled = true;
+                break;
+            }
+            if(n % Integral(p) == 0)
+            {
+                settled = true;
+                break;
+            }
+        }
+        if(settled) continue;
+
+        if(n < Integral(SIEVE_LIMIT * SIEVE_LIMIT)) results[i] = 1;
+        else remaining.push_back(i);
+    }
+
+    DBGOUT("Batch of " << values.size() << ", " << remaining.size() << " left after trial division");
+
+    switch(policy)
+    {
+        case Batch_Policy::Serial:
+            for(const size_t& i : remaining)
+                results[i] = isPrime<Integral>(values[i], test, iterations);
+            break;
+
+        case Batch_Policy::Threaded:
+        {
+            //No more threads than values left, and none when trial division settled them all
+            const size_t workers = std::min<size_t>(remaining.size(), std::max<size_t>(1, std::thread::hardware_concurrency()));
+            std::vector<std::thread> threads;
+            for(size_t w = 0; w < workers; w++)
+            {
+                threads.emplace_back([&, w]()
+                {
+                    for(size_t j = w; j < remaining.size(); j += workers)
+                        results[remaining[j]] = isPrime<Integral>(values[remaining[j]], test, iterations);
+                });
+            }
+            for(std::thread& t : threads)
+                t.join();
+            break;
+        }
+
+        case Batch_Policy::SIMD:
+        {
+            std::vector<size_t> index;
+            std::vector<uint32_t> small;
+            for(const size_t& i : remaining)
+            {
+                if(log2<Integral>(values[i]) < 32)
+                {
+                    index.push_back(i);
+                    small.push_back((uint32_t)toUint64<Integral>(values[i]));
+                }
+                else results[i] = isPrime<Integral>(values[i], test, iterations);
+            }
+
+            std::vector<uint8_t> smallResults(small.size());
+            batch::isPrime(small.data(), smallResults.data(), small.size());
+            for(size_t j = 0; j < index.size(); j++)
+                results[index[j]] = smallResults[j];
+            break;
+        }
+    }
+
+    for(const uint8_t& r : results)
+        *out++ = (r != 0);
+    return out;
 }
 
 /*! \brief Finds the first prime greater than some number
@@ -260,7 +630,7 @@ Integral nextPrime(Integral start, const uint64_t& reps = 20)
     else start += 2;
 
     //Check all odd numbers > start for next prime
-    while(!isPrime(start, Primality_Test::MillerRabin, reps)) start += 2;
+    while(!isPrime<Primality_Test::MillerRabin, Integral>(start, reps)) start += 2;
     
     return start;
 }
@@ -340,4 +710,284 @@ Integral randomPrime(UniformRandomBitGenerator& bits, const uint64_t& bitcount,
     return _randomPrime<Integral, UniformRandomBitGenerator>(bits, bitcount, prime_reps);
 }
 
-}
\ No newline at end of file
+/*! \brief Sieves a window of prime candidates by the small primes
+
+Marks candidates \f$ c_k = start + k*step \f$ for \f$ 0 \leq k < width \f$ which are divisible by
+one of the odd primes below 2048. For each prime \f$ p \f$, the first \f$ k \f$ with \f$ c_k \equiv 0 \f$ mod \f$ p \f$
+is found with one inverse mod \f$ p \f$, and every \f$ p \f$th candidate after it is marked; so a window costs one
+division of start per small prime, rather than a division of every candidate.
+
+When searching for safe primes, candidates with \f$ c_k \equiv 1 \f$ mod \f$ p \f$ are marked too, because then \f$ p \f$
+divides \f$ (c_k-1)/2 \f$. A candidate which is a small prime (or twice one plus one, for safe primes) is never marked
+
+Template arguments
+    - class Integral - Some integer type
+
+\param[in] start - The first candidate
+\param[in] step - Distance between candidates, which must be 2 or 4
+\param[in] width - Number of candidates
+\param[in] safe - Whether or not to also sieve \f$ (c_k-1)/2 \f$
+\returns vector<uint8_t> - 1 for each candidate which has a small factor, 0 otherwise
+*/
+template<class Integral>
+std::vector<uint8_t> _sievePrimeWindow(const Integral& start, const uint64_t& step, const uint64_t& width, const bool& safe)
+{
+    constexpr uint64_t SIEVE_LIMIT = 2048;
+    static constexpr auto smallPrimes = primeTable<SIEVE_LIMIT>();
+
+    std::vector<uint8_t> marks(width, 0);
+    bool small = start < Integral(2 * SIEVE_LIMIT + 2);
+    uint64_t start64 = small ? toUint64<Integral>(start) : 0;
+
+    for(const uint64_t& p : smallPrimes)
+    {
+        if(p == 2) continue;
+
+        uint64_t r = toUint64<Integral>(mod<Integral>(start, Integral(p)));
+        uint64_t inv = (uint64_t)inverseMod<int64_t>(step % p, p);
+
+        //Candidates which are 0 mod p, and those which are 1 mod p for safe primes
+        for(uint64_t target = 0; target < (safe ? 2 : 1); target++)
+        {
+            uint64_t skip = target ? 2 * p + 1 : p;
+            for(uint64_t k = ((target + p - r) % p) * inv % p; k < width; k += p)
+            {
+                if(small && start64 + k * step == skip) continue;
+                marks[k] = 1;
+            }
+        }
+    }
+    return marks;
+}
+
+/*! \brief Searches a window of candidates for a prime
+
+Sieves the window with _sievePrimeWindow(), and then tests the remaining candidates in order with
+the Miller-Rabin test. For safe primes, \f$ (c-1)/2 \f$ is tested before \f$ c \f$
+
+Template arguments
+    - class Integral - Some integer type
+
+\param[in] start - The first candidate
+\param[in] step - Distance between candidates, which must be 2 or 4
+\param[in] width - Number of candidates
+\param[in] max - Candidates greater than or equal to this are not tested
+\param[in] safe - Whether or not to search for a safe prime
+\param[in] prime_reps - Number of iterations to do probabalistic primality test
+\param[out] result - The first prime found
+\param[in] stop - If given, the search gives up as soon as this is set
+\returns bool - Whether or not a prime was found
+*/
+template<class Integral>
+bool _searchPrimeWindow(const Integral& start, const uint64_t& step, const uint64_t& width, const Integral& max,
+                        const bool& safe, const uint64_t& prime_reps, Integral& result, const std::atomic<bool>* stop = nullptr)
+{
+    std::vector<uint8_t> marks = _sievePrimeWindow<Integral>(start, step, width, safe);
+
+    Integral c = start;
+    for(uint64_t k = 0; k < width && c < max; k++, c += step)
+    {
+        if(stop && *stop) return false;
+        if(marks[k]) continue;
+        if(safe && !isPrime<Primality_Test::MillerRabin, Integral>((c - 1) / 2, prime_reps)) continue;
+        if(isPrime<Primality_Test::MillerRabin, Integral>(c, prime_reps))
+        {
+            result = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*! \brief Generates a random prime congruent to 3 mod 4, with a specific number of bits
+
+Picks a random start with the same number of bits as randomPrime(), moves it to the next value congruent to 3 mod 4,
+and searches windows of candidates in steps of 4 with _searchPrimeWindow(). If the top of the range is
+reached, the search continues from the bottom of the range up to the random start.
+
+When safe is set, only safe primes \f$ p = 2q+1 \f$ with \f$ q \f$ prime are accepted. Every safe prime larger than 7
+is congruent to 3 mod 4, so the same candidates are searched, and the sieve removes candidates where either \f$ p \f$ or
+\f$ q \f$ has a small factor
+
+Template arguments
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
+
+\param[in, out] bits - A random bit generator
+\param[in] bitcount - Number of bits in final value
+\param[in] safe - Whether or not to only accept safe primes
+\param[in] prime_reps - Number of iterations to do probabalistic primality test
+\returns Integral - A random prime with the specified number of bits
+\throws domain_error : There is no prime of the requested form in the range
+*/
+template<class Integral, class UniformRandomBitGenerator>
+Integral _randomSievedPrime(UniformRandomBitGenerator& bits, const uint64_t& bitcount, const bool& safe, const uint64_t& prime_reps = 20)
+{
+    DBGOUT("Random sieved prime: " << bitcount << (safe ? " safe" : " blum"));
+    const uint64_t WINDOW = 4096;
+    Integral min = powInt<Integral>(2, bitcount);
+    Integral max = powInt<Integral>(2, bitcount+1);
+
+    Integral start = 1;
+    for(uint64_t i=0; i < bitcount; i++)
+        start = start*2 + mod2<typename UniformRandomBitGenerator::result_type>(bits());
+
+    //Move to 3 mod 4; min is a multiple of 4, so this stays in range
+    start = start - mod<Integral>(start, 4) + 3;
+
+    //Search up to the top of the range, and then wrap around to the bottom
+    Integral result;
+    for(Integral c = start; c < max; c += 4 * WINDOW)
+        if(_searchPrimeWindow<Integral>(c, 4, WINDOW, max, safe, prime_reps, result))
+            return result;
+
+    for(Integral c = min + 3; c < start; c += 4 * WINDOW)
+        if(_searchPrimeWindow<Integral>(c, 4, WINDOW, start, safe, prime_reps, result))
+            return result;
+
+    throw std::domain_error("no prime of requested form and length");
+}
+
+/*! \brief Generates a random Blum prime with a specific number of bits
+
+A Blum prime is a prime congruent to 3 mod 4, such as the primes used by the Blum Blum Shub generator.
+Candidates are only drawn from values congruent to 3 mod 4, and a window of them is sieved by small primes
+at once, so no time is spent testing primes which would be rejected. The result is in the same range as randomPrime()
+
+Template arguments
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
+
+\param[in, out] bits - A random bit generator
+\param[in] bitcount - Number of bits in final value
+\param[in] prime_reps - Number of iterations to do probabalistic primality test
+\returns Integral - A random prime \f$ p \equiv 3 \f$ mod 4 with the specified number of bits
+\throws logic_error : Integral type cannot hold a prime of the size requested
+\throws domain_error : bitcount is less than 2
+*/
+template<class Integral, class UniformRandomBitGenerator>
+Integral randomBlumPrime(UniformRandomBitGenerator& bits, const uint64_t& bitcount, const uint64_t& prime_reps = 20)
+{
+    if(!hasBits<Integral>(bitcount+2))
+        throw std::logic_error("type not large enough for random prime with specific length");
+    if(bitcount < 2)
+        throw std::domain_error("no blum primes with requested length");
+
+    return _randomSievedPrime<Integral, UniformRandomBitGenerator>(bits, bitcount, false, prime_reps);
+}
+
+/*! \brief Generates a random safe prime with a specific number of bits
+
+A safe prime is a prime \f$ p = 2q+1 \f$ where \f$ q \f$ is also prime, as used for Diffie-Hellman groups. The candidate window
+is sieved for both \f$ p \f$ and \f$ q \f$ at once, so only candidates where neither has a small factor are tested. The result is
+in the same range as randomPrime()
+
+Template arguments
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
+
+\param[in, out] bits - A random bit generator
+\param[in] bitcount - Number of bits in final value
+\param[in] prime_reps - Number of iterations to do probabalistic primality test
+\returns Integral - A random safe prime with the specified number of bits
+\throws logic_error : Integral type cannot hold a prime of the size requested
+\throws domain_error : bitcount is less than 2
+*/
+template<class Integral, class UniformRandomBitGenerator>
+Integral randomSafePrime(UniformRandomBitGenerator& bits, const uint64_t& bitcount, const uint64_t& prime_reps = 20)
+{
+    if(!hasBits<Integral>(bitcount+2))
+        throw std::logic_error("type not large enough for random prime with specific length");
+    if(bitcount < 2)
+        throw std::domain_error("no safe primes with requested length");
+
+    return _randomSievedPrime<Integral, UniformRandomBitGenerator>(bits, bitcount, true, prime_reps);
+}
+
+/*! \brief Generates a random prime with a specific number of bits, searching with many threads
+
+Random windows of odd candidates are searched in parallel. The start of every window is drawn from bits on the calling
+thread, in order, before any searching is done. Each round, one window per worker is drawn, and each worker sieves and
+searches its window with _searchPrimeWindow(). The result is the prime from the lowest numbered window which contains one;
+when a window finds a prime, all higher numbered windows in the round are cancelled, but lower numbered ones run to completion.
+
+Because the windows and the rule for picking between them depend only on the values drawn from bits, the result for a given seed
+does not depend on thread timing, or on the number of workers. The number of values drawn from bits does depend on the number of workers.
+The result is in the same range as randomPrime()
+
+Template arguments
+    - class Integral - Some integer type
+    - class UniformRandomBitGenerator - Some type meeting the C++ UniformRandomBitGenerator specification
+
+\param[in, out] bits - A random bit generator
+\param[in] bitcount - Number of bits in final value
+\param[in] workers - Number of threads to search with (Default one per hardware core)
+\param[in] prime_reps - Number of iterations to do probabalistic primality test
+\returns Integral - A random prime with the specified number of bits
+\throws logic_error : Integral type cannot hold a prime of the size requested
+*/
+template<class Integral, class UniformRandomBitGenerator>
+Integral randomPrimeParallel(UniformRandomBitGenerator& bits, const uint64_t& bitcount,
+                             uint64_t workers = std::thread::hardware_concurrency(), const uint64_t& prime_reps = 20)
+{
+    if(!hasBits<Integral>(bitcount+2))
+        throw std::logic_error("type not large enough for random prime with specific length");
+
+    DBGOUT("Random prime parallel: " << bitcount << " with " << workers << " workers");
+    const uint64_t WINDOW = std::max<uint64_t>(64, bitcount);
+    Integral max = powInt<Integral>(2, bitcount+1);
+    workers = std::max<uint64_t>(1, workers);
+
+    while(true)
+    {
+        //Draw every window start for this round before searching
+        std::vector<Integral> starts(workers);
+        for(Integral& start : starts)
+        {
+            start = 1;
+            for(uint64_t i=0; i < bitcount; i++)
+                start = start*2 + mod2<typename UniformRandomBitGenerator::result_type>(bits());
+            if(mod2<Integral>(start) == 0) start += 1;
+        }
+
+        std::vector<Integral> results(workers);
+        std::unique_ptr<std::atomic<bool>[]> stop(new std::atomic<bool>[workers]);
+        std::vector<uint8_t> found(workers, 0);
+        std::vector<std::exception_ptr> errors(workers);
+        for(uint64_t w = 0; w < workers; w++)
+            stop[w] = false;
+
+        std::vector<std::thread> threads;
+        for(uint64_t w = 0; w < workers; w++)
+        {
+            threads.emplace_back([&, w]()
+            {
+                try
+                {
+                    if(_searchPrimeWindow<Integral>(starts[w], 2, WINDOW, max, false, prime_reps, results[w], &stop[w]))
+                    {
+                        found[w] = 1;
+                        for(uint64_t j = w + 1; j < workers; j++)
+                            stop[j] = true;
+                    }
+                }
+                catch(...)
+                {
+                    errors[w] = std::current_exception();
+                    for(uint64_t j = 0; j < workers; j++)
+                        stop[j] = true;
+                }
+            });
+        }
+        for(std::thread& t : threads)
+            t.join();
+
+        for(const std::exception_ptr& e : errors)
+            if(e) std::rethrow_exception(e);
+
+        for(uint64_t w = 0; w < workers; w++)
+            if(found[w]) return results[w];
+    }
+}
+
+}
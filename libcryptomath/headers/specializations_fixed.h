@@ -0,0 +1,492 @@
+/*! \file */
+#pragma once
+
+#include "./fixed_uint.h"
+#include "./math_misc.h"
+#include "./math_modulararith.h"
+#include "./math_primality.h"
+
+namespace cryptomath
+{
+
+/*! \brief Floor of square root for fixed_uint
+
+Newton's method, starting from a power of 2 which is known to be at least
+the square root. Each step is guaranteed to move down towards the floor of
+the root, so the loop stops as soon as a step fails to decrease the estimate.
+
+Template arguments
+    - uint64_t Bits - Number of bits in the fixed_uint type
+
+\param[in] n Value to square root
+\returns fixed_uint - Square root of n rounded down
+*/
+template<uint64_t Bits>
+fixed_uint<Bits> _fixedSqrtfloor(const fixed_uint<Bits>& n)
+{
+    if(n == 0) return 0;
+
+    fixed_uint<Bits> x = fixed_uint<Bits>(1) << ((n.bitlength() + 1) / 2);
+    while(true)
+    {
+        fixed_uint<Bits> y = (x + n / x) / 2;
+        if(y >= x) return x;
+        x = y;
+    }
+}
+
+/*! \brief PowMod for fixed_uint
+
+Odd moduli (which is every modulus the primality tests use) are handled with
+Montgomery multiplication, so no division is done inside the exponentiation loop.
+Even moduli fall back to the generic _powMod() in a type twice as wide, so the
+intermediate products cannot overflow.
+
+Template arguments
+    - uint64_t Bits - Number of bits in the fixed_uint type
+
+\param[in] a
+\param[in] b
+\param[in] n
+\returns fixed_uint - \f$ a^b\f$ mod \f$ n \f$
+*/
+template<uint64_t Bits>
+fixed_uint<Bits> _fixedPowMod(const fixed_uint<Bits>& a, const fixed_uint<Bits>& b, const fixed_uint<Bits>& n)
+{
+    if(n == 1) return 0;
+    if(n.bit(0) == 1)
+        return montgomery<Bits>(n).pow(a, b);
+
+    typedef fixed_uint<2*Bits> wide;
+    return fixed_uint<Bits>(_powMod<wide>(wide(a), wide(b), wide(n)));
+}
+
+/*! \brief Factors all powers of 2 out of a fixed_uint
+
+The number of 2's is the number of trailing zero bits, so this is one scan over
+the limbs and one shift
+
+Template arguments
+    - uint64_t Bits - Number of bits in the fixed_uint type
+
+\param[in] n - The number to factor 2's from
+\returns pair<fixed_uint, fixed_uint> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<uint64_t Bits>
+std::pair<fixed_uint<Bits>, fixed_uint<Bits>> _fixedFactor2s(const fixed_uint<Bits>& n)
+{
+    if(n == 0) return std::make_pair(fixed_uint<Bits>(0), fixed_uint<Bits>(0));
+
+    uint64_t r = n.trailingZeros();
+    return std::make_pair(fixed_uint<Bits>(r), n >> r);
+}
+
+/*! \brief Jacobi symbol for fixed_uint
+
+The generic _jacobi() negates its result, which wraps around for an unsigned type.
+The sign is tracked separately instead, and a symbol of -1 is returned as \f$ n-1 \f$,
+which is the same value mod \f$ n \f$. Powers of 2 are shifted out all at once, and
+residues mod 4 and 8 are read from the lowest bits.
+
+Template arguments
+    - uint64_t Bits - Number of bits in the fixed_uint type
+
+\param[in] a
+\param[in] n - Some odd integer
+\returns fixed_uint - \f$ (\frac{a}{n}) \f$ mod \f$ n \f$, so 0, 1, or \f$ n-1 \f$
+*/
+template<uint64_t Bits>
+fixed_uint<Bits> _fixedJacobi(fixed_uint<Bits> a, fixed_uint<Bits> n)
+{
+    const fixed_uint<Bits> original = n;
+    auto low = [](const fixed_uint<Bits>& x, int bits)
+    {
+        int out = 0;
+        for(int i = bits - 1; i >= 0; i--)
+            out = 2 * out + x.bit(i);
+        return out;
+    };
+
+    bool negative = false;
+    a = a % n;
+    while(a != 0)
+    {
+        // Jacobi(2,n) = -1 if n=3,5 (mod 8)
+        uint64_t r = a.trailingZeros();
+        a = a >> r;
+        if(r % 2 && (low(n, 3) == 3 || low(n, 3) == 5))
+            negative = !negative;
+
+        // Quadratic reciprocity: Jacobi(a,b) = -Jacobi(b,a) if a=3,b=3 (mod 4)
+        std::swap(a, n);
+        if(low(a, 2) == 3 && low(n, 2) == 3)
+            negative = !negative;
+
+        a = a % n;
+    }
+
+    if(n != 1) return 0;
+    return negative ? original - 1 : fixed_uint<Bits>(1);
+}
+
+/*! Template specialization of mod2() for uint128
+
+Reads the lowest bit directly
+
+\param[in] n - The number to mod by 2
+\returns uint8_t - n modded by 2
+*/
+template<>
+uint8_t inline mod2<uint128>(const uint128& n)
+{
+    return n.bit(0);
+}
+
+/*! Template specialization of mod2() for uint256
+
+Reads the lowest bit directly
+
+\param[in] n - The number to mod by 2
+\returns uint8_t - n modded by 2
+*/
+template<>
+uint8_t inline mod2<uint256>(const uint256& n)
+{
+    return n.bit(0);
+}
+
+/*! Template specialization of mod2() for uint512
+
+Reads the lowest bit directly
+
+\param[in] n - The number to mod by 2
+\returns uint8_t - n modded by 2
+*/
+template<>
+uint8_t inline mod2<uint512>(const uint512& n)
+{
+    return n.bit(0);
+}
+
+/*! Template specialization of mod2() for uint1024
+
+Reads the lowest bit directly
+
+\param[in] n - The number to mod by 2
+\returns uint8_t - n modded by 2
+*/
+template<>
+uint8_t inline mod2<uint1024>(const uint1024& n)
+{
+    return n.bit(0);
+}
+
+/*! Template specialization of log2() for uint128
+
+\param[in] n - Number to take log2 of
+\returns uint64_t - Floor of log base 2 of n (0 for 0)
+*/
+template<>
+uint64_t inline log2<uint128>(const uint128& n)
+{
+    return n == 0 ? 0 : n.bitlength() - 1;
+}
+
+/*! Template specialization of log2() for uint256
+
+\param[in] n - Number to take log2 of
+\returns uint64_t - Floor of log base 2 of n (0 for 0)
+*/
+template<>
+uint64_t inline log2<uint256>(const uint256& n)
+{
+    return n == 0 ? 0 : n.bitlength() - 1;
+}
+
+/*! Template specialization of log2() for uint512
+
+\param[in] n - Number to take log2 of
+\returns uint64_t - Floor of log base 2 of n (0 for 0)
+*/
+template<>
+uint64_t inline log2<uint512>(const uint512& n)
+{
+    return n == 0 ? 0 : n.bitlength() - 1;
+}
+
+/*! Template specialization of log2() for uint1024
+
+\param[in] n - Number to take log2 of
+\returns uint64_t - Floor of log base 2 of n (0 for 0)
+*/
+template<>
+uint64_t inline log2<uint1024>(const uint1024& n)
+{
+    return n == 0 ? 0 : n.bitlength() - 1;
+}
+
+/*! Template specialization of sqrtfloor() for uint128
+
+\param[in] n - Number to find square root of
+\returns uint128 - Floor of square root of n
+*/
+template<>
+uint128 inline sqrtfloor<uint128>(const uint128& n)
+{
+    return _fixedSqrtfloor(n);
+}
+
+/*! Template specialization of sqrtfloor() for uint256
+
+\param[in] n - Number to find square root of
+\returns uint256 - Floor of square root of n
+*/
+template<>
+uint256 inline sqrtfloor<uint256>(const uint256& n)
+{
+    return _fixedSqrtfloor(n);
+}
+
+/*! Template specialization of sqrtfloor() for uint512
+
+\param[in] n - Number to find square root of
+\returns uint512 - Floor of square root of n
+*/
+template<>
+uint512 inline sqrtfloor<uint512>(const uint512& n)
+{
+    return _fixedSqrtfloor(n);
+}
+
+/*! Template specialization of sqrtfloor() for uint1024
+
+\param[in] n - Number to find square root of
+\returns uint1024 - Floor of square root of n
+*/
+template<>
+uint1024 inline sqrtfloor<uint1024>(const uint1024& n)
+{
+    return _fixedSqrtfloor(n);
+}
+
+/*! Template specialization of abs() for uint128
+
+The fixed_uint types are unsigned, so this does nothing
+
+\param[in] a Value to absolute
+\returns uint128 - |a|
+*/
+template<>
+uint128 inline abs<uint128>(const uint128& a){ return a; }
+
+/*! Template specialization of abs() for uint256
+
+The fixed_uint types are unsigned, so this does nothing
+
+\param[in] a Value to absolute
+\returns uint256 - |a|
+*/
+template<>
+uint256 inline abs<uint256>(const uint256& a){ return a; }
+
+/*! Template specialization of abs() for uint512
+
+The fixed_uint types are unsigned, so this does nothing
+
+\param[in] a Value to absolute
+\returns uint512 - |a|
+*/
+template<>
+uint512 inline abs<uint512>(const uint512& a){ return a; }
+
+/*! Template specialization of abs() for uint1024
+
+The fixed_uint types are unsigned, so this does nothing
+
+\param[in] a Value to absolute
+\returns uint1024 - |a|
+*/
+template<>
+uint1024 inline abs<uint1024>(const uint1024& a){ return a; }
+
+/*! Template specialization of powMod() for uint128
+
+The generic powMod() requires that \f$ (n-1)^2 \f$ fits in the type. That
+check is removed because _fixedPowMod() never overflows
+
+\param[in] a
+\param[in] b
+\param[in] n
+\returns uint128 - \f$ a^b\f$ mod \f$ n \f$
+*/
+template<>
+uint128 inline powMod<uint128>(const uint128& a, const uint128& b, const uint128& n)
+{
+    return _fixedPowMod(a, b, n);
+}
+
+/*! Template specialization of powMod() for uint256
+
+The generic powMod() requires that \f$ (n-1)^2 \f$ fits in the type. That
+check is removed because _fixedPowMod() never overflows
+
+\param[in] a
+\param[in] b
+\param[in] n
+\returns uint256 - \f$ a^b\f$ mod \f$ n \f$
+*/
+template<>
+uint256 inline powMod<uint256>(const uint256& a, const uint256& b, const uint256& n)
+{
+    return _fixedPowMod(a, b, n);
+}
+
+/*! Template specialization of powMod() for uint512
+
+The generic powMod() requires that \f$ (n-1)^2 \f$ fits in the type. That
+check is removed because _fixedPowMod() never overflows
+
+\param[in] a
+\param[in] b
+\param[in] n
+\returns uint512 - \f$ a^b\f$ mod \f$ n \f$
+*/
+template<>
+uint512 inline powMod<uint512>(const uint512& a, const uint512& b, const uint512& n)
+{
+    return _fixedPowMod(a, b, n);
+}
+
+/*! Template specialization of powMod() for uint1024
+
+The generic powMod() requires that \f$ (n-1)^2 \f$ fits in the type. That
+check is removed because _fixedPowMod() never overflows
+
+\param[in] a
+\param[in] b
+\param[in] n
+\returns uint1024 - \f$ a^b\f$ mod \f$ n \f$
+*/
+template<>
+uint1024 inline powMod<uint1024>(const uint1024& a, const uint1024& b, const uint1024& n)
+{
+    return _fixedPowMod(a, b, n);
+}
+
+/*! Template specialization of factor2s() for uint128
+
+Uses _fixedFactor2s() to shift out all trailing zeros at once
+
+\param[in] n - The number to factor 2's from
+\returns pair<uint128, uint128> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<>
+std::pair<uint128, uint128> inline factor2s<uint128>(const uint128& n)
+{
+    return _fixedFactor2s(n);
+}
+
+/*! Template specialization of factor2s() for uint256
+
+Uses _fixedFactor2s() to shift out all trailing zeros at once
+
+\param[in] n - The number to factor 2's from
+\returns pair<uint256, uint256> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<>
+std::pair<uint256, uint256> inline factor2s<uint256>(const uint256& n)
+{
+    return _fixedFactor2s(n);
+}
+
+/*! Template specialization of factor2s() for uint512
+
+Uses _fixedFactor2s() to shift out all trailing zeros at once
+
+\param[in] n - The number to factor 2's from
+\returns pair<uint512, uint512> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<>
+std::pair<uint512, uint512> inline factor2s<uint512>(const uint512& n)
+{
+    return _fixedFactor2s(n);
+}
+
+/*! Template specialization of factor2s() for uint1024
+
+Uses _fixedFactor2s() to shift out all trailing zeros at once
+
+\param[in] n - The number to factor 2's from
+\returns pair<uint1024, uint1024> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<>
+std::pair<uint1024, uint1024> inline factor2s<uint1024>(const uint1024& n)
+{
+    return _fixedFactor2s(n);
+}
+
+/*! Template specialization of jacobi() for uint128
+
+The jacobi() function throws for unsigned types, but cannot detect
+fixed_uint with std::is_unsigned. _fixedJacobi() keeps the sign apart
+from the unsigned value, so the result is taken mod \f$ n \f$
+
+\param[in] a
+\param[in] n - Some odd integer
+\returns uint128 - \f$ (\frac{a}{n}) \f$ mod \f$ n \f$, so 0, 1, or \f$ n-1 \f$
+*/
+template<>
+uint128 inline jacobi<uint128>(const uint128& a, const uint128& n)
+{
+    return _fixedJacobi(a, n);
+}
+
+/*! Template specialization of jacobi() for uint256
+
+The jacobi() function throws for unsigned types, but cannot detect
+fixed_uint with std::is_unsigned. _fixedJacobi() keeps the sign apart
+from the unsigned value, so the result is taken mod \f$ n \f$
+
+\param[in] a
+\param[in] n - Some odd integer
+\returns uint256 - \f$ (\frac{a}{n}) \f$ mod \f$ n \f$, so 0, 1, or \f$ n-1 \f$
+*/
+template<>
+uint256 inline jacobi<uint256>(const uint256& a, const uint256& n)
+{
+    return _fixedJacobi(a, n);
+}
+
+/*! Template specialization of jacobi() for uint512
+
+The jacobi() function throws for unsigned types, but cannot detect
+fixed_uint with std::is_unsigned. _fixedJacobi() keeps the sign apart
+from the unsigned value, so the result is taken mod \f$ n \f$
+
+\param[in] a
+\param[in] n - Some odd integer
+\returns uint512 - \f$ (\frac{a}{n}) \f$ mod \f$ n \f$, so 0, 1, or \f$ n-1 \f$
+*/
+template<>
+uint512 inline jacobi<uint512>(const uint512& a, const uint512& n)
+{
+    return _fixedJacobi(a, n);
+}
+
+/*! Template specialization of jacobi() for uint1024
+
+The jacobi() function throws for unsigned types, but cannot detect
+fixed_uint with std::is_unsigned. _fixedJacobi() keeps the sign apart
+from the unsigned value, so the result is taken mod \f$ n \f$
+
+\param[in] a
+\param[in] n - Some odd integer
+\returns uint1024 - \f$ (\frac{a}{n}) \f$ mod \f$ n \f$, so 0, 1, or \f$ n-1 \f$
+*/
+template<>
+uint1024 inline jacobi<uint1024>(const uint1024& a, const uint1024& n)
+{
+    return _fixedJacobi(a, n);
+}
+
+}
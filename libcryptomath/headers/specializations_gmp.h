@@ -18,6 +18,19 @@ bool inline hasBits<mpz_class>(const uint64_t& i)
     return true;
 }
 
+/*! Template specialization of toUint64() for mpz_class
+
+mpz_class cannot be cast to standard types, so the low bits are read directly
+
+\param[in] n - Number to convert, which must fit in 64 bits
+\returns uint64_t - n as a uint64_t
+*/
+template<>
+uint64_t inline toUint64<mpz_class>(const mpz_class& n)
+{
+    return n.get_ui();
+}
+
 /*! Template specialization of log2() for mpz_class
 
 Returns log base 2 of the number. No log function exists in the GMP library, so
@@ -62,11 +75,34 @@ uint8_t inline mod2<mpz_class>(const mpz_class& n)
     return (uint8_t)(mpz_tstbit(n.get_mpz_t(), 0));
 }
 
+/*! Template specialization of factor2s() for mpz_class
+
+Finds the lowest set bit with mpz_scan1, and shifts it out with mpz_tdiv_q_2exp
+
+\param[in] n - The number to factor 2's from
+\returns pair<mpz_class, mpz_class> - [number of 2's factored out, n with all powers of 2 factored out]
+*/
+template<>
+std::pair<mpz_class, mpz_class> inline factor2s<mpz_class>(const mpz_class& n)
+{
+    if(n == 0) return std::make_pair(mpz_class(0), mpz_class(0));
+
+    mp_bitcnt_t r = mpz_scan1(n.get_mpz_t(), 0);
+    mpz_class d;
+    mpz_tdiv_q_2exp(d.get_mpz_t(), n.get_mpz_t(), r);
+    return std::make_pair(mpz_class(r), d);
+}
+
 /*! Template specialization of powMod() for mpz_class
 
 The powMod() function tests that the result type can hold the output
 of the calculation without overflowing. This check is removed
-for the mpz_class type
+for the mpz_class type, and the calculation is handed to mpz_powm, which
+writes directly into the result instead of building a temporary for every
+step of the square-and-multiply loop in _powMod()
+
+Negative exponents are passed to _powMod() so that they behave the same as
+they do for every other type
 
 \param[in] a
 \param[in] b
@@ -75,7 +111,48 @@ for the mpz_class type
 */
 template<>
 mpz_class inline powMod<mpz_class>(const mpz_class& a, const mpz_class& b, const mpz_class& n) {
-    return _powMod<mpz_class>(a, b, n);
+    if(b < 0) return _powMod<mpz_class>(a, b, n);
+
+    mpz_class out;
+    mpz_powm(out.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t(), n.get_mpz_t());
+    return out;
+}
+
+/*! Template specialization of gcd() for mpz_class
+
+Uses mpz_gcd, which is always non-negative and handles 0 the
+same way as the generic gcd()
+
+\param[in] a
+\param[in] b
+\returns mpz_class - gcd(|a|, |b|)
+*/
+template<>
+mpz_class inline gcd<mpz_class>(mpz_class a, mpz_class b)
+{
+    mpz_gcd(a.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+    return a;
+}
+
+/*! Template specialization of inverseMod() for mpz_class
+
+Uses mpz_invert instead of the extended gcd. The inverse is computed
+in place in the result. If the inverse does not exist, 0 is returned like the
+generic inverseMod()
+
+\param[in] a
+\param[in] n
+\returns mpz_class - \f$ a^{-1} \f$ mod \f$ n \f$ (0 if non-existant)
+*/
+template<>
+mpz_class inline inverseMod<mpz_class>(const mpz_class& a, const mpz_class& n)
+{
+    if(n <= 1) return 0;
+
+    mpz_class out;
+    if(!mpz_invert(out.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t()))
+        return 0;
+    return out;
 }
 
 /*! Template specialization of jacobi() for mpz_class
@@ -93,4 +170,35 @@ mpz_class inline jacobi<mpz_class>(const mpz_class& a, const mpz_class& n) {
     return _jacobi<mpz_class>(a, n);
 }
 
+/*! Template specialization of primality::millerRabin() for mpz_class
+
+The Miller-Rabin test is replaced with mpz_probab_prime_p, which does trial division
+and a Baillie-PSW test before running the requested number of Miller-Rabin rounds
+
+\param[in] n The number to test for primality
+\param[in] iterations Number of Miller-Rabin rounds
+\return bool - Whether or not \f$ n \f$ is probably prime
+*/
+template<>
+bool inline primality::millerRabin<mpz_class>(const mpz_class& n, const uint64_t& iterations)
+{
+    return mpz_probab_prime_p(n.get_mpz_t(), iterations) != 0;
+}
+
+/*! Template specialization of nextPrime() for mpz_class
+
+Uses mpz_nextprime, which sieves candidates before testing them. GMP
+chooses its own number of test iterations, so reps is not used
+
+\param[in] start - The number to start at
+\param[in] reps - Unused
+\returns mpz_class - The first prime greater than the starting value
+*/
+template<>
+mpz_class inline nextPrime<mpz_class>(mpz_class start, const uint64_t&)
+{
+    mpz_nextprime(start.get_mpz_t(), start.get_mpz_t());
+    return start;
+}
+
 }
\ No newline at end of file
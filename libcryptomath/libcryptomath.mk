@@ -3,9 +3,10 @@ PWD_CRYPTOMATH := $(CRYPTO_ROOT)/libcryptomath
 $(info Including cryptomath algorithms at $(PWD_CRYPTOMATH))
 
 # Set up object files and headers for this lib
-OBJS_CRYPTOMATH += $(patsubst %.o, $(OBJECTS_DIR)/%.o, continuedfraction.o)
+OBJS_CRYPTOMATH += $(patsubst %.o, $(OBJECTS_DIR)/%.o, continuedfraction.o batchprimality.o)
 HDRS_CRYPTOMATH = $(patsubst %.h, $(PWD_CRYPTOMATH)/headers/%.h, \
-					cryptomath.h continuedfractions.h math_factoring.h math_misc.h math_modulararith.h math_primality.h)
+					cryptomath.h continuedfractions.h math_continuedfractions.h math_attacks.h math_pell.h math_factoring.h math_misc.h math_modulararith.h math_primality.h \
+					fixed_uint.h specializations_fixed.h specializations_gmp.h batchprimality.h)
 
 # Include headers
 INCLUDES += -I$(PWD_CRYPTOMATH)/headers
@@ -0,0 +1,453 @@
+/*!
+ * @file
+ */
+
+#include "../headers/batchprimality.h"
+#include "../headers/math_modulararith.h"
+
+#include <vector>
+#include <array>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    /*! Enables the x86 vector kernels */
+    #define BATCH_X86
+#endif
+
+using namespace std;
+
+namespace cryptomath
+{
+namespace batch
+{
+
+namespace
+{
+
+/*! Montgomery constants for one lane. Values are kept in 64-bit
+ * integers so they can be loaded directly into 64-bit vector lanes
+ */
+struct lane
+{
+    uint64_t n;     /*!< The modulus */
+    uint64_t ninv;  /*!< \f$ n^{-1} \f$ mod \f$ 2^{32} \f$ */
+    uint64_t one;   /*!< \f$ R \f$ mod \f$ n \f$ */
+    uint64_t r2;    /*!< \f$ R^2 \f$ mod \f$ n \f$ */
+};
+
+/*! Computes the Montgomery constants for an odd modulus, with \f$ R = 2^{32} \f$
+ *
+ * @param[in] n Some odd modulus
+ * @returns lane - The constants for n
+ */
+lane montgomeryLane(uint32_t n)
+{
+    //Newton's iteration for the inverse mod 2^32, each step doubles the correct bits
+    uint32_t inv = n;
+    for(int i = 0; i < 4; i++)
+        inv *= 2 - n * inv;
+
+    uint64_t one = ((uint64_t)1 << 32) % n;
+    return lane{n, inv, one, (one * one) % n};
+}
+
+/*! One lane of powMod, for any non-0 modulus
+ *
+ * @param[in] a
+ * @param[in] b
+ * @param[in] n
+ * @returns uint32_t - \f$ a^b \f$ mod \f$ n \f$
+ */
+uint32_t scalarPowMod(uint32_t a, uint32_t b, uint32_t n)
+{
+    return (uint32_t)_powMod<uint64_t>(a, b, n);
+}
+
+/*! One lane of the Miller-Rabin test
+ *
+ * The values 2 and 3 are always prime, and anything else less than 5 or even is always composite.
+ * A witness which is a multiple of \f$ n \f$ tells nothing about \f$ n \f$, so it always passes.
+ *
+ * @param[in] n The value to test
+ * @param[in] a The witness
+ * @returns uint8_t - 1 if a is a witness to n being prime, 0 otherwise
+ */
+uint8_t scalarMillerRabin(uint32_t n, uint32_t a)
+{
+    if(n == 2 || n == 3) return 1;
+    if(n < 5 || n % 2 == 0) return 0;
+
+    a %= n;
+    if(a == 0) return 1;
+
+    uint32_t d = n - 1;
+    int s = __builtin_ctz(d);
+    d >>= s;
+
+    uint64_t x = scalarPowMod(a, d, n);
+    if(x == 1 || x == n - 1) return 1;
+
+    for(int j = 1; j < s; j++)
+    {
+        x = (x * x) % n;
+        if(x == n - 1) return 1;
+        if(x == 1) return 0;
+    }
+    return 0;
+}
+
+#ifdef BATCH_X86
+
+/*! Montgomery multiplication of 4 lanes
+ *
+ * Uses the subtractive form of the reduction. With \f$ m = T n^{-1} \f$ mod \f$ R \f$, the low halves of \f$ T \f$ and \f$ mn \f$
+ * are equal, so \f$ (T - mn)/R \f$ is just the difference of the high halves. That difference is in \f$ (-n, n) \f$ and
+ * never overflows, so this works for any odd modulus below \f$ 2^{32} \f$.
+ *
+ * @param[in] a Values in Montgomery form, in the low half of each 64-bit lane
+ * @param[in] b Values in Montgomery form, in the low half of each 64-bit lane
+ * @param[in] n Moduli
+ * @param[in] ninv Inverses of the moduli mod \f$ 2^{32} \f$
+ * @returns __m256i - \f$ abR^{-1} \f$ mod \f$ n \f$ in each lane
+ */
+__attribute__((target("avx2")))
+inline __m256i montMultiply(const __m256i& a, const __m256i& b, const __m256i& n, const __m256i& ninv)
+{
+    __m256i t = _mm256_mul_epu32(a, b);
+    __m256i m = _mm256_mul_epu32(t, ninv);
+    __m256i mn = _mm256_mul_epu32(m, n);
+    __m256i r = _mm256_sub_epi64(_mm256_srli_epi64(t, 32), _mm256_srli_epi64(mn, 32));
+    __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), r);
+    return _mm256_add_epi64(r, _mm256_and_si256(negative, n));
+}
+
+/*! Exponentiation of 4 lanes in Montgomery form, with a different exponent in each lane
+ *
+ * Every lane does a squaring for every bit of the longest exponent, and the multiply is
+ * blended in only for lanes where the bit is set.
+ *
+ * @param[in] x Bases in Montgomery form
+ * @param[in] b Exponents
+ * @param[in] one \f$ R \f$ mod \f$ n \f$
+ * @param[in] n Moduli
+ * @param[in] ninv Inverses of the moduli mod \f$ 2^{32} \f$
+ * @param[in] bits Number of bits in the longest exponent
+ * @returns __m256i - \f$ x^b \f$ in Montgomery form
+ */
+__attribute__((target("avx2")))
+inline __m256i montPow(const __m256i& x, const __m256i& b, const __m256i& one, const __m256i& n, const __m256i& ninv, int bits)
+{
+    const __m256i ONE = _mm256_set1_epi64x(1);
+
+    __m256i result = one;
+    for(int i = bits - 1; i >= 0; i--)
+    {
+        result = montMultiply(result, result, n, ninv);
+        __m256i product = montMultiply(result, x, n, ninv);
+        __m256i bit = _mm256_and_si256(_mm256_srl_epi64(b, _mm_cvtsi32_si128(i)), ONE);
+        result = _mm256_blendv_epi8(result, product, _mm256_cmpeq_epi64(bit, ONE));
+    }
+    return result;
+}
+
+/*! Loads 4 lanes of constants into vectors
+ *
+ * @param[in] l The lanes
+ * @param[out] n Moduli
+ * @param[out] ninv Inverses of the moduli
+ * @param[out] one \f$ R \f$ mod \f$ n \f$
+ * @param[out] r2 \f$ R^2 \f$ mod \f$ n \f$
+ */
+__attribute__((target("avx2")))
+inline void loadLanes(const array<lane, LANES>& l, __m256i& n, __m256i& ninv, __m256i& one, __m256i& r2)
+{
+    n = _mm256_setr_epi64x(l[0].n, l[1].n, l[2].n, l[3].n);
+    ninv = _mm256_setr_epi64x(l[0].ninv, l[1].ninv, l[2].ninv, l[3].ninv);
+    one = _mm256_setr_epi64x(l[0].one, l[1].one, l[2].one, l[3].one);
+    r2 = _mm256_setr_epi64x(l[0].r2, l[1].r2, l[2].r2, l[3].r2);
+}
+
+/*! AVX2 kernel for powMod. Groups of 4 lanes with odd moduli are computed together,
+ * and anything left over is done one lane at a time
+ *
+ * @param[in] a Bases
+ * @param[in] b Exponents
+ * @param[in] n Moduli
+ * @param[out] out Results
+ * @param[in] count Number of lanes
+ */
+__attribute__((target("avx2")))
+void avx2PowMod(const uint32_t* a, const uint32_t* b, const uint32_t* n, uint32_t* out, size_t count)
+{
+    size_t i = 0;
+    for(; i + LANES <= count; i += LANES)
+    {
+        bool odd = true;
+        uint32_t maxb = 0;
+        for(size_t j = 0; j < LANES; j++)
+        {
+            odd = odd && (n[i+j] & 1);
+            maxb |= b[i+j];
+        }
+
+        if(!odd)
+        {
+            for(size_t j = 0; j < LANES; j++)
+                out[i+j] = scalarPowMod(a[i+j], b[i+j], n[i+j]);
+            continue;
+        }
+
+        array<lane, LANES> l;
+        for(size_t j = 0; j < LANES; j++)
+            l[j] = montgomeryLane(n[i+j]);
+
+        __m256i vn, vninv, vone, vr2;
+        loadLanes(l, vn, vninv, vone, vr2);
+
+        __m256i va = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m256i vb = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(b + i)));
+
+        __m256i x = montMultiply(va, vr2, vn, vninv);
+        x = montPow(x, vb, vone, vn, vninv, maxb ? 32 - __builtin_clz(maxb) : 0);
+        x = montMultiply(x, _mm256_set1_epi64x(1), vn, vninv);
+
+        alignas(32) array<uint64_t, LANES> r;
+        _mm256_store_si256((__m256i*)r.data(), x);
+        for(size_t j = 0; j < LANES; j++)
+            out[i+j] = (uint32_t)r[j];
+    }
+
+    for(; i < count; i++)
+        out[i] = scalarPowMod(a[i], b[i], n[i]);
+}
+
+/*! AVX2 kernel for millerRabin
+ *
+ * Lanes which the scalar test handles without exponentiation (small, even, or a multiple of \f$ n \f$
+ * as the witness) are answered up front and replaced with a dummy lane. The remaining lanes
+ * compute \f$ a^d \f$, and then square up to \f$ s-1 \f$ times, tracking which lanes have
+ * hit \f$ -1 \f$, and which have hit 1 and are finished.
+ *
+ * @param[in] n Values to test
+ * @param[in] a Witnesses
+ * @param[out] out Results
+ * @param[in] count Number of lanes
+ */
+__attribute__((target("avx2")))
+void avx2MillerRabin(const uint32_t* n, const uint32_t* a, uint8_t* out, size_t count)
+{
+    size_t i = 0;
+    for(; i + LANES <= count; i += LANES)
+    {
+        array<lane, LANES> l;
+        alignas(32) array<uint64_t, LANES> aa, dd, ss, fixed;
+        uint32_t maxd = 0;
+        uint64_t maxs = 0;
+        bool any = false;
+
+        for(size_t j = 0; j < LANES; j++)
+        {
+            uint32_t nj = n[i+j];
+            uint32_t aj = nj ? a[i+j] % nj : 0;
+            fixed[j] = (nj < 5 || nj % 2 == 0 || aj == 0);
+
+            if(fixed[j])
+            {
+                out[i+j] = scalarMillerRabin(nj, a[i+j]);
+                nj = 5;
+                aj = 2;
+            }
+            else any = true;
+
+            uint32_t d = nj - 1;
+            ss[j] = __builtin_ctz(d);
+            dd[j] = d >> ss[j];
+            aa[j] = aj;
+            l[j] = montgomeryLane(nj);
+
+            maxd |= dd[j];
+            maxs = ss[j] > maxs ? ss[j] : maxs;
+        }
+
+        if(!any) continue;
+
+        __m256i vn, vninv, vone, vr2;
+        loadLanes(l, vn, vninv, vone, vr2);
+        __m256i vnegone = _mm256_sub_epi64(vn, vone);
+        __m256i vs = _mm256_load_si256((const __m256i*)ss.data());
+
+        __m256i x = montMultiply(_mm256_load_si256((const __m256i*)aa.data()), vr2, vn, vninv);
+        x = montPow(x, _mm256_load_si256((const __m256i*)dd.data()), vone, vn, vninv, 32 - __builtin_clz(maxd));
+
+        //Note that R mod n is never n-R mod n, because n is odd
+        __m256i pass = _mm256_or_si256(_mm256_cmpeq_epi64(x, vone), _mm256_cmpeq_epi64(x, vnegone));
+        __m256i active = _mm256_andnot_si256(pass, _mm256_set1_epi64x(-1));
+
+        for(uint64_t j = 1; j < maxs; j++)
+        {
+            x = montMultiply(x, x, vn, vninv);
+            active = _mm256_and_si256(active, _mm256_cmpgt_epi64(vs, _mm256_set1_epi64x(j)));
+
+            __m256i hit = _mm256_and_si256(active, _mm256_cmpeq_epi64(x, vnegone));
+            pass = _mm256_or_si256(pass, hit);
+            active = _mm256_andnot_si256(_mm256_or_si256(hit, _mm256_cmpeq_epi64(x, vone)), active);
+        }
+
+        alignas(32) array<uint64_t, LANES> r;
+        _mm256_store_si256((__m256i*)r.data(), pass);
+        for(size_t j = 0; j < LANES; j++)
+            if(!fixed[j]) out[i+j] = r[j] ? 1 : 0;
+    }
+
+    for(; i < count; i++)
+        out[i] = scalarMillerRabin(n[i], a[i]);
+}
+
+#endif
+
+}
+
+/*! Checks the processor features at runtime, so a single build of the library can
+ * use the vector kernels on machines which have them and still run on machines which do not.
+ *
+ * @returns Kernel - The fastest kernel this processor can run
+ */
+Kernel bestKernel()
+{
+    return supported(Kernel::AVX2) ? Kernel::AVX2 : Kernel::Scalar;
+}
+
+/*!
+ * @param[in] k The kernel to check
+ * @returns bool - Whether or not this processor can run k
+ */
+bool supported(const Kernel& k)
+{
+    switch(k)
+    {
+        case Kernel::Scalar:
+            return true;
+        case Kernel::AVX2:
+#ifdef BATCH_X86
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/*! Computes a power mod n for each lane. Lanes with an odd modulus are handled by the vector kernel using
+ * Montgomery multiplication with \f$ R = 2^{32} \f$; any group of lanes containing an even modulus falls back to the scalar loop.
+ *
+ * @param[in] a Bases
+ * @param[in] b Exponents
+ * @param[in] n Moduli
+ * @param[out] out \f$ a_i^{b_i} \f$ mod \f$ n_i \f$ for each lane
+ * @param[in] count Number of lanes
+ * @param[in] k Kernel to run (Default the fastest supported)
+ *
+ * @throws domain_error : Some modulus is 0
+ * @throws logic_error : The processor does not support k
+ */
+void powMod(const uint32_t* a, const uint32_t* b, const uint32_t* n, uint32_t* out, size_t count, Kernel k)
+{
+    for(size_t i = 0; i < count; i++)
+        if(n[i] == 0)
+            throw domain_error("powmod with modulus 0");
+
+    if(!supported(k))
+        throw logic_error("batch kernel not supported by this processor");
+
+#ifdef BATCH_X86
+    if(k == Kernel::AVX2)
+        return avx2PowMod(a, b, n, out, count);
+#endif
+
+    for(size_t i = 0; i < count; i++)
+        out[i] = scalarPowMod(a[i], b[i], n[i]);
+}
+
+/*! Runs a single round of the Miller-Rabin test for each lane. See primality::millerRabin for details on the test.
+ *
+ * Every lane can have a different value and witness. The values 2 and 3 are always reported as prime, and
+ * anything else less than 5 or even is always reported as composite. A witness which is a multiple of the
+ * value it is testing tells nothing about the value, so it always passes.
+ *
+ * @param[in] n Values to test
+ * @param[in] a Witness for each value
+ * @param[out] out 1 for each lane where \f$ a_i \f$ is a witness to \f$ n_i \f$ being prime, 0 otherwise
+ * @param[in] count Number of lanes
+ * @param[in] k Kernel to run (Default the fastest supported)
+ *
+ * @throws logic_error : The processor does not support k
+ */
+void millerRabin(const uint32_t* n, const uint32_t* a, uint8_t* out, size_t count, Kernel k)
+{
+    if(!supported(k))
+        throw logic_error("batch kernel not supported by this processor");
+
+#ifdef BATCH_X86
+    if(k == Kernel::AVX2)
+        return avx2MillerRabin(n, a, out, count);
+#endif
+
+    for(size_t i = 0; i < count; i++)
+        out[i] = scalarMillerRabin(n[i], a[i]);
+}
+
+/*! Tests each value for primality. For values less than 4,759,123,141 (which includes all 32-bit values), the Miller-Rabin test
+ * with the witnesses 2, 7, and 61 never gives a false positive, so this test is exact.
+ *
+ * The values are run through the Miller-Rabin test for each witness in turn. After each round, only values
+ * which might still be prime are passed on to the next.
+ *
+ * @param[in] n Values to test
+ * @param[out] out 1 for each value which is prime, 0 otherwise
+ * @param[in] count Number of values
+ * @param[in] k Kernel to run (Default the fastest supported)
+ *
+ * @throws logic_error : The processor does not support k
+ */
+void isPrime(const uint32_t* n, uint8_t* out, size_t count, Kernel k)
+{
+    const array<uint32_t, 3> WITNESSES{{2, 7, 61}};
+
+    vector<size_t> index(count);
+    vector<uint32_t> values(count), witnesses(count);
+    vector<uint8_t> results(count);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        index[i] = i;
+        values[i] = n[i];
+        out[i] = 0;
+    }
+
+    for(const uint32_t& w : WITNESSES)
+    {
+        size_t remaining = index.size();
+        fill(witnesses.begin(), witnesses.begin() + remaining, w);
+        millerRabin(values.data(), witnesses.data(), results.data(), remaining, k);
+
+        size_t kept = 0;
+        for(size_t i = 0; i < remaining; i++)
+        {
+            if(results[i])
+            {
+                index[kept] = index[i];
+                values[kept] = values[i];
+                kept++;
+            }
+        }
+        index.resize(kept);
+    }
+
+    for(const size_t& i : index)
+        out[i] = 1;
+}
+
+}
+}
@@ -32,7 +32,7 @@ namespace continuedfractions
  * The result may contain only an integer value
  *
  * If the result has a cycle, it will not be detected. If you need cycle detection in a simple square root, use
- * ::sqrttocf
+ * sqrttocf()
  *  
  * @param[in] d The real value to convert
  * @param[in] max_iterations Maximum number of iterations to run if the fraction does not terminate sooner
@@ -63,75 +63,6 @@ vector<uint64_t> dtocf(double d, const uint64_t& max_iterations)
     return result;
 }
 
-/*! Finds the continued fraction of a rational as an integer i and a finite set of continued fraction coefficients.
- *
- * @param[in] p The top of the rational to convert
- * @param[in] q The bottom of the rational to convert
- *
- * @returns vector<uint64_t> - The continued fraction, including the integer part
- */
-vector<uint64_t> ftocf(uint64_t p, uint64_t q)
-{
-    DBG(cerr << "Continued fraction of " << p << " / " << q << endl)
-
-    if(q == 0)
-        throw logic_error("divide by 0");
-
-    uint64_t a = p/q;
-    p = p%q;
-
-    vector<uint64_t> result{a};
-
-    int64_t iterations = 0;
-    while(p)
-    {
-        swap(p, q);
-        a = p/q;
-        p = p%q;
-
-        DBG(cerr << "X: " << p << " / " << q << " -- " << a << endl);
-
-        result.emplace_back(a);
-    }
-
-    return result;
-}
-
-/*! Finds the continued fraction of sqrt(n) as an integer i and repeating continued fraction coefficients. The first value in the returned continued
- * fraction is the integer portion, and the remaning values will repeat infinitely. The end of the period is the first
- * value in the repeating fraction a such that \f$ a == 2*i \f$
- *  
- * @param[in] n The value to convert the square root of
- *
- * @returns vector<uint64_t> The continued fraction, including the integer part. Everything except the integer part repeats infinitely
- */
-std::vector<uint64_t> sqrttocf(uint64_t n)
-{
-    DBG(cerr << "Continued fraction of sqrt(" << n << ")" << endl)
-
-    double x = sqrt(n);
-    uint64_t a = floor(x);
-    uint64_t intPart = a;
-
-    vector<uint64_t> result{a};
-
-    //No continuing fraction for perfect squares
-    if(abs(x - a) > 0.0001)
-    {
-        while(intPart != a/2)
-        {
-            x = 1.0/(x - a);
-            a = floor(x);
-
-            DBG(cerr << "X: " << x << " -- " << a << endl);
-
-            result.emplace_back(a);
-        }
-    }
-
-    return result;
-}
-
 /*! Generates all p/q approximations of the continued fraction using the following formulas
  *      - \f$ p(k) = a(k) * p(k-1) + p(k-2) \f$
  *      - \f$ q(k) = a(k) * q(k-1) + q(k-2) \f$
@@ -148,6 +79,7 @@ std::vector<uint64_t> sqrttocf(uint64_t n)
  * @param[in] repetitions The number of times to repeat the non-integer portion beyond the first time.
  *
  * @returns vector<pair<uint64_t, uint64_t>> - All p/q approximations generated by the cf
+ * @throws overflow_error - An approximation does not fit in uint64_t. Use ::convergents to generate them one at a time
  */
 vector<pair<uint64_t, uint64_t>> cftof(const std::vector<uint64_t>& cf, uint64_t repetitions)
 {
@@ -155,20 +87,15 @@ vector<pair<uint64_t, uint64_t>> cftof(const std::vector<uint64_t>& cf, uint64_t
     DBG(for(uint64_t i = 0; i < 10 && i < cf.size(); cerr << cf[i++] << " "); cerr << endl;)
 
     vector<pair<uint64_t, uint64_t>> result;
-
-    pair<uint64_t, uint64_t> p = pair<uint64_t, uint64_t>(0, 1);
-    pair<uint64_t, uint64_t> q = pair<uint64_t, uint64_t>(1, 0);
+    convergents<uint64_t> approximations;
 
     auto end = cf.end();
     auto iter = cf.begin();
     while(iter != end)
     {
-        p = pair<uint64_t, uint64_t>(p.second, (*iter) * p.second + p.first);
-        q = pair<uint64_t, uint64_t>(q.second, (*iter) * q.second + q.first);
-
-        DBG(cerr << p.second << " / " << q.second << endl;)
+        result.push_back(approximations.push(*iter).value());
 
-        result.emplace_back(p.second, q.second);
+        DBG(cerr << result.back().first << " / " << result.back().second << endl;)
 
         iter++;
 
@@ -3,6 +3,8 @@
 
 #include <array>
 #include <string>
+#include <cstdint>
+#include <cstddef>
 
 #ifndef DEBUG
     /*! Removes verbose debug outputs from compiled result */
@@ -17,6 +19,8 @@
 //! Namespace for full DES functionality
 namespace des64
 {
+    class key_schedule;
+
     //! Namespace for internal DES functions; these are not intended to be called by a user
     namespace _internal
     {
@@ -52,27 +56,27 @@ namespace des64
         using permutation = std::array<int8_t, O>;
 
         //! Definition of the initial permutation
-        const permutation<64> IP 
+        constexpr permutation<64> IP 
         {{58, 50, 42, 34, 26, 18, 10, 2, 60, 52, 44, 36, 28, 20, 12, 4,
         62, 54, 46, 38, 30, 22, 14, 6, 64, 56, 48, 40, 32, 24, 16, 8,
         57, 49, 41, 33, 25, 17, 9, 1, 59, 51, 43, 35, 27, 19, 11, 3,
         61, 53, 45, 37, 29, 21, 13, 5, 63, 55, 47, 39, 31, 23, 15, 7}};
 
         //! Definition of the initial permutation inverse
-        const permutation<64> IP_INV 
+        constexpr permutation<64> IP_INV 
         {{40, 8, 48, 16, 56, 24, 64, 32, 39, 7, 47, 15, 55, 23, 63, 31,
         38, 6, 46, 14, 54, 22, 62, 30, 37, 5, 45, 13, 53, 21, 61, 29, 
         36, 4, 44, 12, 52, 20, 60, 28, 35, 3, 43, 11, 51, 19, 59, 27, 
         34, 2, 42, 10, 50, 18, 58, 26, 33, 1, 41, 9, 49, 17, 57, 25}};
 
         //! Definition of the expansion function
-        const permutation<48> EXPAND 
+        constexpr permutation<48> EXPAND 
         {{32, 1, 2, 3, 4, 5, 4, 5, 6, 7, 8, 9, 8, 9, 10, 11, 12, 13, 12,
         13, 14, 15, 16, 17, 16, 17, 18, 19, 20, 21, 20, 21, 22, 23, 24,
         25, 24, 25, 26, 27, 28, 29, 28, 29, 30, 31, 32, 1}};
 
         //! Definition of the permuation of the C blocks before the application of the F function
-        const permutation<32> C_PERMUTE 
+        constexpr permutation<32> C_PERMUTE 
         {{16, 7, 20, 21,
           29, 12, 28, 17,
           1, 15, 23, 26, 
@@ -83,17 +87,17 @@ namespace des64
           22, 11, 4, 25}};
         
         //! Definition of the key permutation to discard parity bits
-        const permutation<56> KEY_PERMUTE 
+        constexpr permutation<56> KEY_PERMUTE 
         {{57, 49, 41, 33, 25, 17, 9, 1, 58, 50, 42, 34, 26, 18, 10, 2, 59, 51,
         43, 35, 27, 19, 11, 3, 60, 52, 44, 36, 63, 55, 47, 39, 31, 23, 15, 7,
         62, 54, 46, 38, 30, 22, 14, 6, 61, 53, 45, 37, 29, 21, 13, 5, 28, 20, 12, 4}};
 
         //! Definition of how far to shift the key on each round
-        const std::array<uint8_t, 16> KEY_SHIFTS
+        constexpr std::array<uint8_t, 16> KEY_SHIFTS
         {{1, 1, 2, 2, 2, 2, 2, 2, 1, 2, 2, 2, 2, 2, 2, 1}};
 
         //! Definition of the permutation for getting bits out of the key to generate \f$ k_i \f$
-        const permutation<48> KEY_CHOOSE
+        constexpr permutation<48> KEY_CHOOSE
         {{14, 17, 11, 24, 1, 5, 3, 28, 15, 6, 21, 10, 23, 19, 12, 4, 26, 8, 16, 7,
         27, 20, 13, 2, 41, 52, 31, 37, 47, 55, 30, 40, 51, 45, 33, 48, 44, 49, 39, 
         56, 34, 53, 46, 42, 50, 36, 29, 32}};
@@ -141,7 +145,7 @@ namespace des64
         }
         \endcode
         */
-        const std::array<S_BOX, 8> S_BOXES{{
+        constexpr std::array<S_BOX, 8> S_BOXES{{
                 {{14, 0, 4, 15, 13, 7, 1, 4, 2, 14, 15, 2, 11, 13, 8, 1,
                 3, 10, 10, 6, 6, 12, 12, 11, 5, 9, 9, 5, 0, 3, 7, 8,
                 4, 15, 1, 12, 14, 8, 8, 2, 13, 4, 6, 9, 2, 1, 11, 7,
@@ -198,7 +202,7 @@ namespace des64
         \returns result - The input permuted according to the table
         */
         template<uint64_t I, uint64_t O, class result = uint64_t>
-        result permute(const uint64_t& block, const permutation<O>& table)
+        constexpr result permute(const uint64_t& block, const permutation<O>& table)
         {
             static_assert(sizeof(result)*8 >= O, "permute output has more bits than type");
 
@@ -217,6 +221,108 @@ namespace des64
             return out;
         }
 
+        /*! \brief Typedef for a permutation precomputed into lookup tables
+
+            Every output bit comes from a single input bit, so a permutation of a value is the OR
+            of the permutations of each of its bytes alone. Entry [b][v] holds the permuted result
+            of the value with byte b (counting from the least significant) set to v and every other
+            bit clear.
+
+            Template arguments
+                - uint64_t I - Number of bits in input
+        */
+        template<uint64_t I>
+        using permutation_table = std::array<std::array<uint64_t, 256>, (I + 7) / 8>;
+
+        /*! Builds the lookup tables for a permutation at compile time
+
+        Template arguments
+            - uint64_t I - number of bits in input
+            - uint64_t O - number of bits in output
+
+        \param[in] table Permutation to precompute
+        \returns permutation_table<I> - The permutation of every byte value in every position
+        */
+        template<uint64_t I, uint64_t O>
+        constexpr permutation_table<I> make_permutation_table(const permutation<O>& table)
+        {
+            permutation_table<I> out{};
+            for(uint64_t b = 0; b < out.size(); b++)
+                for(uint64_t v = 0; v < 256; v++)
+                    out[b][v] = permute<I, O>(v << (8 * b), table);
+
+            return out;
+        }
+
+        /*! Permutation by lookup table
+
+        Permutes a value with one lookup and OR per input byte, instead of
+        a shift and mask per output bit
+
+        Template arguments
+            - uint64_t I - number of bits in input
+            - uint64_t O - number of bits in output
+            - class result - result type; must have at least O bits
+
+        \param[in] block Data to permute
+        \param[in] table Lookup tables from make_permutation_table
+        \returns result - The input permuted according to the table
+        */
+        template<uint64_t I, uint64_t O, class result = uint64_t>
+        constexpr result permute(uint64_t block, const permutation_table<I>& table)
+        {
+            static_assert(sizeof(result)*8 >= O, "permute output has more bits than type");
+
+            uint64_t out = 0;
+            for(uint64_t b = 0; b < table.size(); b++, block >>= 8)
+                out |= table[b][block & 0xFF];
+
+            return (result)out;
+        }
+
+        //! Lookup tables for the initial permutation
+        inline constexpr permutation_table<64> IP_TABLE = make_permutation_table<64, 64>(IP);
+
+        //! Lookup tables for the initial permutation inverse
+        inline constexpr permutation_table<64> IP_INV_TABLE = make_permutation_table<64, 64>(IP_INV);
+
+        //! Lookup tables for the expansion function
+        inline constexpr permutation_table<32> EXPAND_TABLE = make_permutation_table<32, 48>(EXPAND);
+
+        //! Lookup tables for the permutation of the C blocks
+        inline constexpr permutation_table<32> C_PERMUTE_TABLE = make_permutation_table<32, 32>(C_PERMUTE);
+
+        //! Lookup tables for the key permutation
+        inline constexpr permutation_table<64> KEY_PERMUTE_TABLE = make_permutation_table<64, 56>(KEY_PERMUTE);
+
+        //! Lookup tables for choosing \f$ k_i \f$ from the key
+        inline constexpr permutation_table<56> KEY_CHOOSE_TABLE = make_permutation_table<56, 48>(KEY_CHOOSE);
+
+        //! Type for an S-Box combined with the permutation of the C blocks
+        typedef std::array<uint32_t, 64> SP_BOX;
+
+        /*! Combines each S-Box with the permutation of the C blocks at compile time
+
+        The permutation of the C blocks moves bits without mixing them, so permuting the
+        joined outputs of the S-Boxes is the same as ORing together the permutation of each
+        S-Box output in its own position. Entry [i][v] is the output of S-Box i for v, moved
+        into its position in C and permuted.
+
+        \returns array<SP_BOX, 8> - The combined boxes
+        */
+        constexpr std::array<SP_BOX, 8> make_sp_boxes()
+        {
+            std::array<SP_BOX, 8> out{};
+            for(int i = 0; i < 8; i++)
+                for(uint64_t v = 0; v < 64; v++)
+                    out[i][v] = permute<32, 32, uint32_t>((uint64_t)S_BOXES[i][v] << (4 * (7-i)), C_PERMUTE);
+
+            return out;
+        }
+
+        //! The S-Boxes combined with the permutation of the C blocks
+        inline constexpr std::array<SP_BOX, 8> SP_BOXES = make_sp_boxes();
+
         /*! \brief Rotate left function
 
         Template arguments
@@ -243,11 +349,82 @@ namespace des64
 
         //! The DES F function
         uint64_t F(uint64_t ri, const uint64_t& ki);
+
+        //! Performs the 16 rounds and the swap of the halves, between the initial permutation and its inverse
+        uint64_t rounds(uint64_t block, const key_schedule& schedule, bool decrypt);
     }
 
+    /*! \brief The 16 round keys generated from a DES key
+
+        Generating the round keys costs more than encrypting a block, so a schedule
+        is built once from a key and reused for every block encrypted or decrypted with it.
+    */
+    class key_schedule
+    {
+    public:
+        //! Iterator over the round keys, in the order used for encryption
+        typedef std::array<uint64_t, 16>::const_iterator const_iterator;
+        //! Iterator over the round keys, in the order used for decryption
+        typedef std::array<uint64_t, 16>::const_reverse_iterator const_reverse_iterator;
+
+        //! Generates the round keys for the key
+        explicit key_schedule(const uint64_t& key);
+
+        //! \returns const uint64_t& - The key for round i
+        const uint64_t& operator[](size_t i) const { return _keys[i]; }
+        //! \returns const array<uint64_t, 16>& - All of the round keys
+        const std::array<uint64_t, 16>& keys() const { return _keys; }
+
+        //! \returns const_iterator - The key for the first round
+        const_iterator begin() const { return _keys.begin(); }
+        //! \returns const_iterator - Past the key for the last round
+        const_iterator end() const { return _keys.end(); }
+        //! \returns const_reverse_iterator - The key for the last round
+        const_reverse_iterator rbegin() const { return _keys.rbegin(); }
+        //! \returns const_reverse_iterator - Before the key for the first round
+        const_reverse_iterator rend() const { return _keys.rend(); }
+
+    private:
+        std::array<uint64_t, 16> _keys;
+    };
+
+    /*! \brief The round keys of the three DES keys used by triple DES
+
+        Triple DES encrypts with the first key, decrypts with the second and encrypts
+        with the third (EDE). Two-key triple DES (EDE2) reuses the first key as the third.
+        Using the same key three times is the same as single DES.
+    */
+    class triple_key_schedule
+    {
+    public:
+        //! Generates the round keys for two-key triple DES
+        triple_key_schedule(const uint64_t& k1, const uint64_t& k2);
+
+        //! Generates the round keys for three-key triple DES
+        triple_key_schedule(const uint64_t& k1, const uint64_t& k2, const uint64_t& k3);
+
+        //! \returns const key_schedule& - The schedule for stage i, from 0
+        const key_schedule& operator[](size_t i) const { return _schedules[i]; }
+
+    private:
+        std::array<key_schedule, 3> _schedules;
+    };
+
     //! Encrypts a block with the key in 16 rounds
     uint64_t encrypt(uint64_t block, const uint64_t& key);
 
+    //! Encrypts a block with precomputed round keys in 16 rounds
+    uint64_t encrypt(uint64_t block, const key_schedule& schedule);
+
     //! Decrypts a block with the key in 16 rounds
     uint64_t decrypt(uint64_t block, const uint64_t& key);
+
+    //! Decrypts a block with precomputed round keys in 16 rounds
+    uint64_t decrypt(uint64_t block, const key_schedule& schedule);
+
+    //! Encrypts a block with triple DES
+    uint64_t encrypt(uint64_t block, const triple_key_schedule& schedule);
+
+    //! Decrypts a block with triple DES
+    uint64_t decrypt(uint64_t block, const triple_key_schedule& schedule);
 }
\ No newline at end of file
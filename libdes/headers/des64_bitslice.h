@@ -0,0 +1,106 @@
+/*! \file */
+#pragma once
+
+#include "./des64.h"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+//! Namespace for full DES functionality
+namespace des64
+{
+    //! Namespace for internal DES functions; these are not intended to be called by a user
+    namespace _internal
+    {
+        /*! \brief Typedef for 64 values of 64 bits stored as bit planes
+
+            Plane k holds bit k of every value, counting from the most significant bit,
+            with one value per bit of the plane. Each bit of a plane is called a lane.
+        */
+        typedef std::array<uint64_t, 64> planes;
+
+        //! Typedef for the 48 bit planes of the key of each of the 16 rounds
+        typedef std::array<std::array<uint64_t, 48>, 16> round_key_planes;
+
+        /*! Computes which bit of the 64-bit key becomes each bit of each round key
+
+            Combines the key permutation, the shifts and the choice of \f$ k_i \f$, so round
+            keys can be taken straight from the bits of the key without running the key schedule
+
+            \returns array<permutation<48>, 16> - Entry [r][j] is the key bit, counting from 1 at the left, which is bit j of \f$ k_r \f$
+        */
+        constexpr std::array<permutation<48>, 16> make_key_bits()
+        {
+            std::array<permutation<48>, 16> out{};
+            int shift = 0;
+            for(int r = 0; r < 16; r++)
+            {
+                shift += KEY_SHIFTS[r];
+                for(int j = 0; j < 48; j++)
+                {
+                    int p = KEY_CHOOSE[j] - 1;
+                    int half = p / 28 * 28;
+                    out[r][j] = KEY_PERMUTE[half + (p - half + shift) % 28];
+                }
+            }
+
+            return out;
+        }
+
+        //! The key bit which becomes each bit of each round key
+        inline constexpr std::array<permutation<48>, 16> KEY_BITS = make_key_bits();
+
+        //! Transposes a 64x64 bit matrix, converting between values and bit planes
+        void transpose(planes& m);
+
+        //! Round key planes where every lane uses the same key schedule
+        round_key_planes broadcast_key_planes(const key_schedule& schedule);
+
+        //! Round key planes for each stage of triple DES where every lane uses the same key schedules
+        std::array<round_key_planes, 3> broadcast_key_planes(const triple_key_schedule& schedule);
+
+        //! Round key planes where every lane uses its own key, from the bit planes of the keys
+        round_key_planes key_planes(const planes& keys);
+
+        //! Encrypts or decrypts 64 blocks stored as bit planes
+        void bitslice_crypt(planes& data, const round_key_planes& keys, bool decrypt);
+
+        //! Encrypts or decrypts 64 blocks stored as bit planes with triple DES
+        void bitslice_crypt(planes& data, const std::array<round_key_planes, 3>& keys, bool decrypt);
+
+        //! Finds the lanes whose round keys encrypt a block to a ciphertext
+        uint64_t bitslice_match(const uint64_t& plaintext, const uint64_t& ciphertext, const round_key_planes& keys);
+    }
+
+    /*! \brief Bitsliced DES, which encrypts 64 blocks at once
+
+        The blocks are transposed so each bit plane holds the same bit of 64 blocks, and the
+        S-Boxes are evaluated as boolean gates on whole planes. The permutations become a choice
+        of which plane to read, and no value is ever used as a table index, so the time taken
+        does not depend on the blocks or the keys.
+    */
+    namespace bitslice
+    {
+        //! Number of blocks encrypted in one pass
+        constexpr size_t LANES = 64;
+
+        //! Encrypts many blocks with one key schedule
+        void encrypt(const uint64_t* blocks, uint64_t* out, size_t count, const key_schedule& schedule);
+
+        //! Decrypts many blocks with one key schedule
+        void decrypt(const uint64_t* blocks, uint64_t* out, size_t count, const key_schedule& schedule);
+
+        //! Encrypts many blocks with triple DES
+        void encrypt(const uint64_t* blocks, uint64_t* out, size_t count, const triple_key_schedule& schedule);
+
+        //! Decrypts many blocks with triple DES
+        void decrypt(const uint64_t* blocks, uint64_t* out, size_t count, const triple_key_schedule& schedule);
+
+        //! Encrypts one block with many keys
+        void encrypt(const uint64_t& block, const uint64_t* keys, uint64_t* out, size_t count);
+
+        //! Decrypts one block with many keys
+        void decrypt(const uint64_t& block, const uint64_t* keys, uint64_t* out, size_t count);
+    }
+}
@@ -0,0 +1,41 @@
+/*! \file */
+#pragma once
+
+#include "./des64_search.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <thread>
+
+//! Namespace for full DES functionality
+namespace des64
+{
+    //! Namespace for exhaustive key search
+    namespace search
+    {
+        //! A range of key indices [first, last)
+        typedef std::pair<uint64_t, uint64_t> index_range;
+
+        //! The first and second keys of double DES
+        typedef std::pair<uint64_t, uint64_t> key_pair;
+
+        //! Default bytes of memory for the table of middle values
+        constexpr size_t MEET_MEMORY = size_t(1) << 30;
+
+        //! Bytes of memory used for each entry of the table while it is built
+        constexpr size_t MEET_ENTRY_BYTES = 2 * sizeof(uint64_t);
+
+        //! Number of passes a meet-in-the-middle attack makes with a memory limit
+        uint64_t meet_passes(const index_range& first, size_t memory = MEET_MEMORY);
+
+        //! The first keys in the table of one pass of a meet-in-the-middle attack
+        index_range meet_pass_range(const index_range& first, uint64_t pass, size_t memory = MEET_MEMORY);
+
+        //! Finds the keys of double DES which encrypt every known plaintext to its ciphertext
+        std::vector<key_pair> meet_in_the_middle(const std::vector<known_pair>& pairs,
+                                                 const index_range& first = {0, KEY_SPACE}, const index_range& second = {0, KEY_SPACE},
+                                                 size_t memory = MEET_MEMORY, uint64_t workers = std::thread::hardware_concurrency());
+    }
+}
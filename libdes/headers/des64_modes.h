@@ -0,0 +1,84 @@
+/*! \file */
+#pragma once
+
+#include "./des64.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <thread>
+
+//! Namespace for full DES functionality
+namespace des64
+{
+    //! Number of bytes in a DES block
+    constexpr size_t BLOCK_BYTES = 8;
+
+    /*! \brief Modes of operation for encrypting buffers longer than one block
+
+        - ECB encrypts each block alone
+        - CBC XORs each plaintext block with the last ciphertext block before encrypting it
+        - CFB XORs each plaintext block with the encryption of the last ciphertext block
+        - OFB XORs the plaintext with a keystream made by encrypting the IV over and over
+        - CTR XORs the plaintext with the encryption of a counter starting at the IV
+
+        ECB and CBC require a whole number of blocks, so use pkcs7_pad() first.
+        CFB, OFB and CTR encrypt any number of bytes.
+    */
+    enum class Mode
+    {
+        ECB,
+        CBC,
+        CFB,
+        OFB,
+        CTR
+    };
+
+    //! Reads 8 bytes as a block, with the first byte as the most significant
+    uint64_t load_block(const uint8_t* in);
+
+    //! Writes a block as 8 bytes, with the most significant byte first
+    void store_block(const uint64_t& block, uint8_t* out);
+
+    //! Encrypts a buffer in a mode of operation
+    void encrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv = 0);
+
+    //! Encrypts a buffer in a mode of operation with triple DES
+    void encrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv = 0);
+
+    //! Decrypts a buffer in a mode of operation
+    void decrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv = 0);
+
+    //! Decrypts a buffer in a mode of operation with triple DES
+    void decrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv = 0);
+
+    //! Buffers shorter than this are not split across threads
+    constexpr size_t PARALLEL_THRESHOLD = 1 << 20;
+
+    //! Default number of bytes each thread processes at a time
+    constexpr size_t PARALLEL_CHUNK = 1 << 18;
+
+    //! Encrypts a large buffer in a mode of operation across threads
+    void encrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv = 0,
+                          size_t chunk = PARALLEL_CHUNK, uint64_t workers = std::thread::hardware_concurrency());
+
+    //! Encrypts a large buffer in a mode of operation across threads with triple DES
+    void encrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv = 0,
+                          size_t chunk = PARALLEL_CHUNK, uint64_t workers = std::thread::hardware_concurrency());
+
+    //! Decrypts a large buffer in a mode of operation across threads
+    void decrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv = 0,
+                          size_t chunk = PARALLEL_CHUNK, uint64_t workers = std::thread::hardware_concurrency());
+
+    //! Decrypts a large buffer in a mode of operation across threads with triple DES
+    void decrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv = 0,
+                          size_t chunk = PARALLEL_CHUNK, uint64_t workers = std::thread::hardware_concurrency());
+
+    //! Length of a buffer after PKCS#7 padding
+    size_t pkcs7_length(size_t length);
+
+    //! Pads a buffer in place with PKCS#7
+    size_t pkcs7_pad(uint8_t* buffer, size_t length);
+
+    //! Finds the length of a buffer without its PKCS#7 padding
+    size_t pkcs7_unpad(const uint8_t* buffer, size_t length);
+}
@@ -0,0 +1,144 @@
+/*! \file */
+#pragma once
+
+#include "./des64_bitslice.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <thread>
+
+//! Namespace for full DES functionality
+namespace des64
+{
+    //! Namespace for internal DES functions; these are not intended to be called by a user
+    namespace _internal
+    {
+        //! Bit planes of the keys of 64 consecutive search indices
+        planes index_planes(uint64_t base);
+
+        //! The indices in [low, high) of the lanes set in a mask of 64 consecutive search indices
+        std::vector<uint64_t> match_indices(uint64_t match, uint64_t base, uint64_t low, uint64_t high);
+    }
+
+    /*! \brief Exhaustive key search with known plaintexts
+
+        Only 56 bits of a DES key are used; the lowest bit of each byte is parity. Keys are
+        searched by an index from 0 to \f$ 2^{56} \f$, where each byte of the key holds 7 bits of
+        the index above its parity bit, so every index is a valid key and none are skipped.
+    */
+    namespace search
+    {
+        //! Number of distinct DES keys
+        constexpr uint64_t KEY_SPACE = 1ULL << 56;
+
+        //! Number of indices a thread takes from the range at a time
+        constexpr uint64_t SLICE = 1 << 16;
+
+        //! A plaintext and the ciphertext it encrypts to
+        typedef std::pair<uint64_t, uint64_t> known_pair;
+
+        /*! Finds the key for an index, with each byte given odd parity
+
+            \param[in] index The index of the key, less than KEY_SPACE
+            \returns uint64_t - The key which passes the parity check
+        */
+        constexpr uint64_t key_at(uint64_t index)
+        {
+            uint64_t key = 0;
+            for(int b = 0; b < 8; b++)
+            {
+                uint64_t byte = ((index >> (7 * b)) & 0x7F) << 1;
+                uint64_t parity = byte ^ (byte >> 4);
+                parity ^= parity >> 2;
+                parity ^= parity >> 1;
+                key |= (byte | (~parity & 1)) << (8 * b);
+            }
+
+            return key;
+        }
+
+        /*! Finds the index of a key, ignoring its parity bits
+
+            \param[in] key The DES key
+            \returns uint64_t - The index for which key_at() gives the key with correct parity
+        */
+        constexpr uint64_t index_of(uint64_t key)
+        {
+            uint64_t index = 0;
+            for(int b = 0; b < 8; b++)
+                index |= ((key >> (8 * b + 1)) & 0x7F) << (7 * b);
+
+            return index;
+        }
+
+        //! The state of a search, which can be saved and resumed later
+        struct checkpoint
+        {
+            //! The first index not yet searched
+            uint64_t next;
+            //! One past the last index to search
+            uint64_t last;
+            //! The keys found so far
+            std::vector<uint64_t> keys;
+        };
+
+        //! Writes a checkpoint as text
+        std::ostream& operator<<(std::ostream& out, const checkpoint& state);
+
+        //! Reads a checkpoint written by operator<<
+        std::istream& operator>>(std::istream& in, checkpoint& state);
+
+        /*! \brief Searches a range of key indices for the keys which encrypt every known plaintext to its ciphertext
+
+            64 keys are tried at once with the bitsliced DES on the first pair, and give up after 15
+            rounds when none of them can match. Keys which match the first pair are checked against
+            the rest. The range is searched in order, a call to run() at a time, so the search can be
+            stopped between calls and resumed from a checkpoint.
+        */
+        class key_search
+        {
+            public:
+                //! Prepares to search the indices in [first, last)
+                key_search(const std::vector<known_pair>& pairs, uint64_t first = 0, uint64_t last = KEY_SPACE);
+
+                //! Prepares to continue a saved search
+                key_search(const std::vector<known_pair>& pairs, const checkpoint& resume);
+
+                //! Searches the next count indices across threads
+                uint64_t run(uint64_t count = KEY_SPACE, uint64_t workers = std::thread::hardware_concurrency());
+
+                //! Whether the whole range has been searched
+                bool done() const { return _next == _last; }
+
+                //! The first index not yet searched
+                uint64_t next() const { return _next; }
+
+                //! The keys found so far, in increasing order of index
+                const std::vector<uint64_t>& keys() const { return _keys; }
+
+                //! Number of keys tried by this object
+                uint64_t searched() const { return _searched; }
+
+                //! Seconds spent in run() by this object
+                double seconds() const { return _seconds; }
+
+                //! Keys tried per second by this object
+                double keys_per_second() const { return _seconds > 0 ? _searched / _seconds : 0; }
+
+                //! The state of the search, to resume it later
+                checkpoint save() const { return {_next, _last, _keys}; }
+
+            private:
+                std::vector<known_pair> _pairs;
+                uint64_t _next;
+                uint64_t _last;
+                std::vector<uint64_t> _keys;
+                uint64_t _searched = 0;
+                double _seconds = 0;
+        };
+    }
+}
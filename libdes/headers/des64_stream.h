@@ -0,0 +1,56 @@
+/*! \file */
+#pragma once
+
+#include "./des64_modes.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+//! Namespace for full DES functionality
+namespace des64
+{
+    //! Default number of bytes encrypted between writes to the output
+    constexpr size_t STREAM_CHUNK = 1 << 22;
+
+    /*! \brief Encrypting and decrypting files and streams
+
+        The input is memory mapped when it is a regular file, and otherwise read in chunks, so
+        pipes and sockets work too. Each chunk is encrypted with the mode functions, carrying the
+        chaining value on to the next chunk, and written out before the next is started, so the
+        whole input is never held in memory.
+
+        ECB and CBC pad the plaintext with PKCS#7 when encrypting and remove it when decrypting.
+        CFB, OFB and CTR output exactly as many bytes as they read.
+    */
+    namespace stream
+    {
+        //! Encrypts everything read from a file descriptor to another
+        uint64_t encrypt(Mode mode, int in, int out, const key_schedule& schedule, const uint64_t& iv = 0, size_t chunk = STREAM_CHUNK);
+
+        //! Encrypts everything read from a file descriptor to another with triple DES
+        uint64_t encrypt(Mode mode, int in, int out, const triple_key_schedule& schedule, const uint64_t& iv = 0, size_t chunk = STREAM_CHUNK);
+
+        //! Decrypts everything read from a file descriptor to another
+        uint64_t decrypt(Mode mode, int in, int out, const key_schedule& schedule, const uint64_t& iv = 0, size_t chunk = STREAM_CHUNK);
+
+        //! Decrypts everything read from a file descriptor to another with triple DES
+        uint64_t decrypt(Mode mode, int in, int out, const triple_key_schedule& schedule, const uint64_t& iv = 0, size_t chunk = STREAM_CHUNK);
+
+        //! Encrypts a file to another path
+        uint64_t encrypt(Mode mode, const std::string& in, const std::string& out, const key_schedule& schedule, const uint64_t& iv = 0,
+                         size_t chunk = STREAM_CHUNK);
+
+        //! Encrypts a file to another path with triple DES
+        uint64_t encrypt(Mode mode, const std::string& in, const std::string& out, const triple_key_schedule& schedule, const uint64_t& iv = 0,
+                         size_t chunk = STREAM_CHUNK);
+
+        //! Decrypts a file to another path
+        uint64_t decrypt(Mode mode, const std::string& in, const std::string& out, const key_schedule& schedule, const uint64_t& iv = 0,
+                         size_t chunk = STREAM_CHUNK);
+
+        //! Decrypts a file to another path with triple DES
+        uint64_t decrypt(Mode mode, const std::string& in, const std::string& out, const triple_key_schedule& schedule, const uint64_t& iv = 0,
+                         size_t chunk = STREAM_CHUNK);
+    }
+}
@@ -3,8 +3,8 @@ PWD_DES := $(CRYPTO_ROOT)/libdes
 $(info Including DES algorithms at $(PWD_DES))
 
 # List all requirements for library
-OBJS_DES = $(patsubst %.o, $(OBJECTS_DIR)/%.o, des64.o des4.o)
-HDRS_DES = $(patsubst %.h, $(PWD_DES)/headers/%.h, des64.h des4.h)
+OBJS_DES = $(patsubst %.o, $(OBJECTS_DIR)/%.o, des64.o des64_bitslice.o des64_modes.o des64_stream.o des64_search.o des64_meet.o des4.o)
+HDRS_DES = $(patsubst %.h, $(PWD_DES)/headers/%.h, des64.h des64_bitslice.h des64_modes.h des64_stream.h des64_search.h des64_meet.h des4.h)
 
 # Include headers
 INCLUDES += -I$(PWD_DES)/headers 
@@ -10,6 +10,13 @@ namespace des64
     namespace _internal
     {
         /*!
+            The expansion copies each 4 bits of ri with the bit on either
+            side of them, so the 6 bits entering S-Box i are bits 4i to 4i+5
+            of ri, counting from the left with wraparound. They are taken by
+            shifting a rotated copy of ri rather than expanding it, XORed with
+            the matching 6 bits of ki, and looked up in SP_BOXES, which already
+            applies the permutation of the C blocks.
+
             \param[in] ri Right half of block i
             \param[in] ki Key for round i
             \returns uint64_t
@@ -18,23 +25,17 @@ namespace des64
         {
             DBG(cerr << "F(" << bin(ri) << ")" << endl);
 
-            ri = permute<32, 48, uint64_t>(ri, EXPAND);
-            DBG(cerr << "Permuted " << bin(ri) << endl);
-
-            ri ^= ki;
-            DBG(cerr << "XOR ki " << bin(ri) << endl);
+            //Rotate by 1 so bits 4i to 4i+5 never wrap, then double so they are a plain shift
+            uint64_t r = rotate_left<32>(ri & 0xFFFFFFFF, 1) & 0xFFFFFFFF;
+            r |= r << 32;
 
             uint64_t C = 0;
-            for(int i=7; i>=0; i--)
+            for(int i=0; i<8; i++)
             {
-                C |= ((S_BOXES[i][ri & 0x3F]) << (4 * (7-i)));
-                ri >>= 6;
+                C |= SP_BOXES[i][((r >> (28 - 4*i)) ^ (ki >> (42 - 6*i))) & 0x3F];
                 DBG(cerr << "C " << bin(C) << endl);
             }
 
-            C = permute<32, 32, uint64_t>(C, C_PERMUTE);
-            DBG(cerr << "Permuted " << bin(C) << endl);
-
             return C;
         }        
 
@@ -93,7 +94,7 @@ namespace des64
             DBG(cerr << "Make keys from " << bin(key) << endl);
             array<uint64_t, 16> out;
 
-            uint64_t c0d0 = permute<64, 56, uint64_t>(key, KEY_PERMUTE);
+            uint64_t c0d0 = permute<64, 56>(key, KEY_PERMUTE_TABLE);
             DBG(cerr << "Permutation " << bin(c0d0) << endl);
 
             for(int i=0; i < 16; i++)
@@ -101,7 +102,7 @@ namespace des64
                 uint64_t c1d1 = ((rotate_left<28>(c0d0 >> 28, KEY_SHIFTS[i]) & 0xFFFFFFF) << 28) | (rotate_left<28>(c0d0 & 0xFFFFFFF, KEY_SHIFTS[i]) & 0xFFFFFFF);
                 DBG(cerr << "CiDi\t" << bin(c1d1) << endl);
 
-                out[i] = permute<56, 48, uint64_t>(c1d1, KEY_CHOOSE);
+                out[i] = permute<56, 48>(c1d1, KEY_CHOOSE_TABLE);
                 DBG(cerr << "Ki\t" << bin(out[i]) << endl << endl);
 
                 c0d0 = c1d1;
@@ -109,79 +110,180 @@ namespace des64
 
             return out;
         }        
+
+        /*!
+            \param[in] block The block after the initial permutation
+            \param[in] schedule The round keys
+            \param[in] decrypt Whether to use the round keys in reverse order
+            \returns uint64_t - The block before the inverse of the initial permutation
+        */
+        uint64_t rounds(uint64_t block, const key_schedule& schedule, bool decrypt)
+        {
+            for(int i = 0; i < 16; i++)
+            {
+                block = round(block, schedule[decrypt ? 15 - i : i]);
+                DBG(cerr << "Round " << bin(block) << endl);
+            }
+
+            //Flip block
+            block = (block >> 32) | (block << 32);
+            DBG(cerr << "Flip " << bin(block) << endl);
+
+            return block;
+        }
+    }
+
+    /*!
+        \param[in] key The 64-bit DES key
+        \throws logic_error : The key does not pass the parity check
+    */
+    key_schedule::key_schedule(const uint64_t& key) : _keys(_internal::make_keys(key))
+    {
     }
 
     /*!
         The encryption process is as follows
-            - Generate 16 round keys
             - Apply the initial permutation to the block
             - Encrypt the block with 16 rounds, using the keys in order
             - Swap the left and right halves of the block
             - Apply the inverse of the initial permutation
 
         \param[in] block The data to encrypt
-        \param[in] key The 64-bit DES key
+        \param[in] schedule The round keys of the DES key
         \returns uint64_t - The encrypted block
-        \throws logic_error : The key does not pass the parity check
     */
-    uint64_t encrypt(uint64_t block, const uint64_t& key)
+    uint64_t encrypt(uint64_t block, const key_schedule& schedule)
     {
         using namespace _internal;
 
-        DBG(cerr << "Encrypt " << bin(block) << " : " << bin(key) << endl);
-        array<uint64_t, 16> keys = make_keys(key);
+        DBG(cerr << "Encrypt " << bin(block) << endl);
 
         //Initial permute
-        block = permute<64, 64, uint64_t>(block, IP);
+        block = permute<64, 64>(block, IP_TABLE);
         DBG(cerr << "IP " << bin(block) << endl);
 
-        for(auto iter = keys.begin(); iter != keys.end(); iter++)
-        {
-            block = round(block, *iter);
-            DBG(cerr << "Round " << bin(block) << endl);
-        }
-
-        //Flip block
-        block = (block >> 32) | (block << 32);
-        DBG(cerr << "Flip " << bin(block) << endl);
+        block = rounds(block, schedule, false);
 
         //Inverse permute
-        block = permute<64, 64, uint64_t>(block, IP_INV);
+        block = permute<64, 64>(block, IP_INV_TABLE);
         DBG(cerr << "IP-1 " << bin(block) << endl);
         
         return block;
     }
 
+    /*!
+        Generates the round keys and encrypts with them. Use a key_schedule
+        when encrypting more than one block with the same key.
+
+        \param[in] block The data to encrypt
+        \param[in] key The 64-bit DES key
+        \returns uint64_t - The encrypted block
+        \throws logic_error : The key does not pass the parity check
+    */
+    uint64_t encrypt(uint64_t block, const uint64_t& key)
+    {
+        DBG(cerr << "Key " << _internal::bin(key) << endl);
+        return encrypt(block, key_schedule(key));
+    }
+
     /*!
         The decryption process is as follows
-            - Generate 16 round keys
             - Apply the initial permutation to the block
             - Decrypt the block with 16 rounds, using the keys in reverse order
             - Swap the left and right halves of the block
             - Apply the inverse of the initial permutation
 
         \param[in] block The data to decrypt
-        \param[in] key The 64-bit DES key
+        \param[in] schedule The round keys of the DES key
         \returns uint64_t - The decrypted block
-        \throws logic_error : The key does not pass the parity check
     */
-    uint64_t decrypt(uint64_t block, const uint64_t& key)
+    uint64_t decrypt(uint64_t block, const key_schedule& schedule)
     {
         using namespace _internal;
 
         //Inverse permute
-        block = permute<64, 64, uint64_t>(block, IP);
+        block = permute<64, 64>(block, IP_TABLE);
 
-        array<uint64_t, 16> keys = make_keys(key);
-        for(auto iter = keys.rbegin(); iter != keys.rend(); iter++)
-            block = round(block, *iter);
-            
-        //Flip block
-        block = (block >> 32) | (block << 32);
+        block = rounds(block, schedule, true);
 
         //Initial permute
-        block = permute<64, 64, uint64_t>(block, IP_INV);
+        block = permute<64, 64>(block, IP_INV_TABLE);
 
         return block;
     }
-}
\ No newline at end of file
+
+    /*!
+        Generates the round keys and decrypts with them. Use a key_schedule
+        when decrypting more than one block with the same key.
+
+        \param[in] block The data to decrypt
+        \param[in] key The 64-bit DES key
+        \returns uint64_t - The decrypted block
+        \throws logic_error : The key does not pass the parity check
+    */
+    uint64_t decrypt(uint64_t block, const uint64_t& key)
+    {
+        return decrypt(block, key_schedule(key));
+    }
+
+    /*!
+        \param[in] k1 The 64-bit DES key for the first and third stages
+        \param[in] k2 The 64-bit DES key for the second stage
+        \throws logic_error : A key does not pass the parity check
+    */
+    triple_key_schedule::triple_key_schedule(const uint64_t& k1, const uint64_t& k2) : triple_key_schedule(k1, k2, k1)
+    {
+    }
+
+    /*!
+        \param[in] k1 The 64-bit DES key for the first stage
+        \param[in] k2 The 64-bit DES key for the second stage
+        \param[in] k3 The 64-bit DES key for the third stage
+        \throws logic_error : A key does not pass the parity check
+    */
+    triple_key_schedule::triple_key_schedule(const uint64_t& k1, const uint64_t& k2, const uint64_t& k3) :
+        _schedules{{key_schedule(k1), key_schedule(k2), key_schedule(k3)}}
+    {
+    }
+
+    /*!
+        Computes \f$ E_{k_3}(D_{k_2}(E_{k_1}(block))) \f$. Each stage ends with the
+        inverse of the initial permutation and the next starts with the initial
+        permutation, so those pairs cancel and are skipped.
+
+        \param[in] block The data to encrypt
+        \param[in] schedule The round keys of the three DES keys
+        \returns uint64_t - The encrypted block
+    */
+    uint64_t encrypt(uint64_t block, const triple_key_schedule& schedule)
+    {
+        using namespace _internal;
+
+        block = permute<64, 64>(block, IP_TABLE);
+        block = rounds(block, schedule[0], false);
+        block = rounds(block, schedule[1], true);
+        block = rounds(block, schedule[2], false);
+
+        return permute<64, 64>(block, IP_INV_TABLE);
+    }
+
+    /*!
+        Computes \f$ D_{k_1}(E_{k_2}(D_{k_3}(block))) \f$, skipping the permutations
+        between the stages
+
+        \param[in] block The data to decrypt
+        \param[in] schedule The round keys of the three DES keys
+        \returns uint64_t - The decrypted block
+    */
+    uint64_t decrypt(uint64_t block, const triple_key_schedule& schedule)
+    {
+        using namespace _internal;
+
+        block = permute<64, 64>(block, IP_TABLE);
+        block = rounds(block, schedule[2], true);
+        block = rounds(block, schedule[1], false);
+        block = rounds(block, schedule[0], true);
+
+        return permute<64, 64>(block, IP_INV_TABLE);
+    }
+}
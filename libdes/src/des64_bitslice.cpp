@@ -0,0 +1,444 @@
+#include "../headers/des64_bitslice.h"
+
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+namespace des64
+{
+    namespace _internal
+    {
+        namespace
+        {
+            /*!
+                Computes the 8 minterms of 3 planes. Minterm i is set in the lanes
+                where a, b and c are the bits of i, from the most significant.
+
+                \param[in] a First plane
+                \param[in] b Second plane
+                \param[in] c Third plane
+                \param[out] out The 8 minterms
+            */
+            inline void minterms(const uint64_t& a, const uint64_t& b, const uint64_t& c, uint64_t* out)
+            {
+                const uint64_t ab[4] = {~a & ~b, ~a & b, a & ~b, a & b};
+                for(int i = 0; i < 4; i++)
+                {
+                    out[2*i] = ab[i] & ~c;
+                    out[2*i + 1] = ab[i] & c;
+                }
+            }
+
+            /*!
+                The lanes where output bit BIT of S-Box BOX is set, among the lanes whose first
+                3 input bits are H. This is the OR of the minterms of the last 3 input bits which
+                set the output bit; the S-Box is constant, so the unused minterms fold away.
+
+                \param[in] low Minterms of the last 3 input bits
+                \returns uint64_t - The lanes where the output bit is set
+            */
+            template<int BOX, int BIT, int H, size_t... L>
+            inline uint64_t sbox_column(const uint64_t* low, index_sequence<L...>)
+            {
+                return (((S_BOXES[BOX][8*H + L] >> (3 - BIT)) & 1 ? low[L] : 0) | ...);
+            }
+
+            /*!
+                \param[in] high Minterms of the first 3 input bits
+                \param[in] low Minterms of the last 3 input bits
+                \returns uint64_t - The lanes where output bit BIT of S-Box BOX is set
+            */
+            template<int BOX, int BIT, size_t... H>
+            inline uint64_t sbox_bit(const uint64_t* high, const uint64_t* low, index_sequence<H...>)
+            {
+                return ((high[H] & sbox_column<BOX, BIT, H>(low, make_index_sequence<8>())) | ...);
+            }
+
+            /*!
+                Evaluates S-Box BOX on 6 input planes as a sum of products, built at
+                compile time from the S-Box table
+
+                \param[in] in The 6 input planes, from the most significant bit
+                \param[out] out The 4 output planes, from the most significant bit
+            */
+            template<int BOX>
+            inline void sbox(const uint64_t* in, uint64_t* out)
+            {
+                uint64_t high[8], low[8];
+                minterms(in[0], in[1], in[2], high);
+                minterms(in[3], in[4], in[5], low);
+
+                out[0] = sbox_bit<BOX, 0>(high, low, make_index_sequence<8>());
+                out[1] = sbox_bit<BOX, 1>(high, low, make_index_sequence<8>());
+                out[2] = sbox_bit<BOX, 2>(high, low, make_index_sequence<8>());
+                out[3] = sbox_bit<BOX, 3>(high, low, make_index_sequence<8>());
+            }
+
+            /*!
+                Performs a round on bit planes, XORing F of the right half into the left half.
+                The caller swaps the halves.
+
+                \param[in, out] l Planes of the left half
+                \param[in] r Planes of the right half
+                \param[in] k Planes of the round key
+            */
+            inline void bitslice_round(uint64_t* l, const uint64_t* r, const array<uint64_t, 48>& k)
+            {
+                uint64_t x[48], c[32];
+                for(int j = 0; j < 48; j++)
+                    x[j] = r[EXPAND[j] - 1] ^ k[j];
+
+                sbox<0>(x, c);
+                sbox<1>(x + 6, c + 4);
+                sbox<2>(x + 12, c + 8);
+                sbox<3>(x + 18, c + 12);
+                sbox<4>(x + 24, c + 16);
+                sbox<5>(x + 30, c + 20);
+                sbox<6>(x + 36, c + 24);
+                sbox<7>(x + 42, c + 28);
+
+                for(int j = 0; j < 32; j++)
+                    l[j] ^= c[C_PERMUTE[j] - 1];
+            }
+        }
+
+        /*!
+            Swaps blocks of the matrix in 6 steps, halving the block size
+            each step, as in Hacker's Delight. The transpose of bit planes
+            is the values again, so the same function converts both ways.
+
+            \param[in, out] m The matrix to transpose
+        */
+        void transpose(planes& m)
+        {
+            uint64_t mask = 0x00000000FFFFFFFF;
+            for(int j = 32; j; j >>= 1, mask ^= mask << j)
+            {
+                for(int k = 0; k < 64; k = ((k | j) + 1) & ~j)
+                {
+                    uint64_t t = (m[k] ^ (m[k | j] >> j)) & mask;
+                    m[k] ^= t;
+                    m[k | j] ^= t << j;
+                }
+            }
+        }
+
+        /*!
+            \param[in] schedule The round keys to use in every lane
+            \returns round_key_planes - Planes which are all ones or all zeros
+        */
+        round_key_planes broadcast_key_planes(const key_schedule& schedule)
+        {
+            round_key_planes out;
+            for(int r = 0; r < 16; r++)
+                for(int j = 0; j < 48; j++)
+                    out[r][j] = 0 - ((schedule[r] >> (47 - j)) & 1);
+
+            return out;
+        }
+
+        /*!
+            \param[in] schedule The round keys of the three DES keys to use in every lane
+            \returns array<round_key_planes, 3> - Planes for each stage which are all ones or all zeros
+        */
+        array<round_key_planes, 3> broadcast_key_planes(const triple_key_schedule& schedule)
+        {
+            return {{broadcast_key_planes(schedule[0]), broadcast_key_planes(schedule[1]), broadcast_key_planes(schedule[2])}};
+        }
+
+        /*!
+            The parity bits of the keys are not checked
+
+            \param[in] keys The bit planes of the keys
+            \returns round_key_planes - The bit planes of the round keys of every lane
+        */
+        round_key_planes key_planes(const planes& keys)
+        {
+            round_key_planes out;
+            for(int r = 0; r < 16; r++)
+                for(int j = 0; j < 48; j++)
+                    out[r][j] = keys[KEY_BITS[r][j] - 1];
+
+            return out;
+        }
+
+        namespace
+        {
+            /*!
+                \param[in] data The bit planes of the blocks
+                \param[out] halves The left and right halves after the initial permutation
+            */
+            inline void initial_permute(const planes& data, uint64_t (&halves)[2][32])
+            {
+                for(int j = 0; j < 32; j++)
+                {
+                    halves[0][j] = data[IP[j] - 1];
+                    halves[1][j] = data[IP[j + 32] - 1];
+                }
+            }
+
+            /*!
+                Performs 16 rounds, swapping the halves by swapping pointers. The
+                last round is not swapped, so afterwards l holds the right half.
+
+                \param[in, out] l Planes of the left half
+                \param[in, out] r Planes of the right half
+                \param[in] keys The bit planes of the round keys
+                \param[in] decrypt Whether to use the round keys in reverse order
+            */
+            inline void bitslice_rounds(uint64_t*& l, uint64_t*& r, const round_key_planes& keys, bool decrypt)
+            {
+                for(int i = 0; i < 16; i++)
+                {
+                    bitslice_round(l, r, keys[decrypt ? 15 - i : i]);
+                    swap(l, r);
+                }
+                swap(l, r);
+            }
+
+            /*!
+                \param[in] l Planes of the first half
+                \param[in] r Planes of the second half
+                \param[out] data The bit planes of the blocks after the inverse of the initial permutation
+            */
+            inline void final_permute(const uint64_t* l, const uint64_t* r, planes& data)
+            {
+                for(int j = 0; j < 64; j++)
+                {
+                    int p = IP_INV[j] - 1;
+                    data[j] = p < 32 ? l[p] : r[p - 32];
+                }
+            }
+        }
+
+        /*!
+            The initial permutation and its inverse only choose which plane
+            is read, and the halves are swapped by swapping pointers.
+
+            \param[in, out] data The bit planes of the blocks
+            \param[in] keys The bit planes of the round keys
+            \param[in] decrypt Whether to use the round keys in reverse order
+        */
+        void bitslice_crypt(planes& data, const round_key_planes& keys, bool decrypt)
+        {
+            uint64_t halves[2][32];
+            initial_permute(data, halves);
+
+            uint64_t* l = halves[0];
+            uint64_t* r = halves[1];
+            bitslice_rounds(l, r, keys, decrypt);
+
+            final_permute(l, r, data);
+        }
+
+        /*!
+            Runs the three stages of triple DES between one initial permutation
+            and one inverse, since the permutations between the stages cancel.
+
+            \param[in, out] data The bit planes of the blocks
+            \param[in] keys The bit planes of the round keys of each stage
+            \param[in] decrypt Whether to decrypt
+        */
+        void bitslice_crypt(planes& data, const array<round_key_planes, 3>& keys, bool decrypt)
+        {
+            uint64_t halves[2][32];
+            initial_permute(data, halves);
+
+            uint64_t* l = halves[0];
+            uint64_t* r = halves[1];
+            for(int stage = 0; stage < 3; stage++)
+            {
+                //Encrypt is E1 D2 E3, and decrypt is D3 E2 D1
+                int k = decrypt ? 2 - stage : stage;
+                bitslice_rounds(l, r, keys[k], decrypt != (stage == 1));
+            }
+
+            final_permute(l, r, data);
+        }
+        /*!
+            Every lane encrypts the same plaintext with its own round keys. The ciphertext after the
+            initial permutation is \f$ R_{16} L_{16} \f$, and \f$ L_{16} = R_{15} \f$, so after 15 rounds
+            half of the ciphertext can already be compared. The last round is only run when some lane
+            still matches, and each comparison stops once no lane does.
+
+            \param[in] plaintext The block to encrypt in every lane
+            \param[in] ciphertext The block to look for
+            \param[in] keys The bit planes of the round keys of every lane
+            \returns uint64_t - The lanes which encrypt plaintext to ciphertext, in the same bit order as the planes
+        */
+        uint64_t bitslice_match(const uint64_t& plaintext, const uint64_t& ciphertext, const round_key_planes& keys)
+        {
+            planes data;
+            for(int j = 0; j < 64; j++)
+                data[j] = 0 - ((plaintext >> (63 - j)) & 1);
+
+            uint64_t halves[2][32];
+            initial_permute(data, halves);
+
+            uint64_t* l = halves[0];
+            uint64_t* r = halves[1];
+            for(int i = 0; i < 15; i++)
+            {
+                bitslice_round(l, r, keys[i]);
+                swap(l, r);
+            }
+
+            const uint64_t target = permute<64, 64>(ciphertext, IP_TABLE);
+            uint64_t match = ~0ULL;
+            for(int j = 0; j < 32 && match; j++)
+                match &= ~(r[j] ^ (0 - ((target >> (31 - j)) & 1)));
+
+            if(!match)
+                return 0;
+
+            bitslice_round(l, r, keys[15]);
+            for(int j = 0; j < 32 && match; j++)
+                match &= ~(l[j] ^ (0 - ((target >> (63 - j)) & 1)));
+
+            return match;
+        }
+    }
+
+    namespace bitslice
+    {
+        namespace
+        {
+            /*!
+                Template arguments
+                    - class Keys - round_key_planes for single DES, or an array of 3 for triple DES
+
+                \param[in] blocks The blocks to process
+                \param[out] out Where to write the result; may be the same as blocks
+                \param[in] count Number of blocks
+                \param[in] keys The bit planes of the round keys
+                \param[in] decrypt Whether to decrypt
+            */
+            template<class Keys>
+            void crypt_blocks(const uint64_t* blocks, uint64_t* out, size_t count, const Keys& keys, bool decrypt)
+            {
+                using namespace _internal;
+
+                for(size_t i = 0; i < count; i += LANES)
+                {
+                    const size_t n = min(count - i, LANES);
+
+                    planes data{};
+                    copy(blocks + i, blocks + i + n, data.begin());
+
+                    transpose(data);
+                    bitslice_crypt(data, keys, decrypt);
+                    transpose(data);
+
+                    copy(data.begin(), data.begin() + n, out + i);
+                }
+            }
+
+            /*!
+                \param[in] block The block to process
+                \param[in] keys The 64-bit DES keys
+                \param[out] out Where to write the result for each key
+                \param[in] count Number of keys
+                \param[in] decrypt Whether to decrypt
+                \throws logic_error : A key does not pass the parity check
+            */
+            void crypt_keys(const uint64_t& block, const uint64_t* keys, uint64_t* out, size_t count, bool decrypt)
+            {
+                using namespace _internal;
+
+                planes broadcast;
+                for(int j = 0; j < 64; j++)
+                    broadcast[j] = 0 - ((block >> (63 - j)) & 1);
+
+                for(size_t i = 0; i < count; i += LANES)
+                {
+                    const size_t n = min(count - i, LANES);
+
+                    planes key{};
+                    for(size_t j = 0; j < n; j++)
+                    {
+                        if(!parity_check(keys[i + j]))
+                            throw logic_error("key parity check failed");
+                        key[j] = keys[i + j];
+                    }
+                    transpose(key);
+
+                    planes data = broadcast;
+                    bitslice_crypt(data, key_planes(key), decrypt);
+                    transpose(data);
+
+                    copy(data.begin(), data.begin() + n, out + i);
+                }
+            }
+        }
+
+        /*!
+            \param[in] blocks The blocks to encrypt
+            \param[out] out Where to write the encrypted blocks; may be the same as blocks
+            \param[in] count Number of blocks
+            \param[in] schedule The round keys of the DES key
+        */
+        void encrypt(const uint64_t* blocks, uint64_t* out, size_t count, const key_schedule& schedule)
+        {
+            crypt_blocks(blocks, out, count, _internal::broadcast_key_planes(schedule), false);
+        }
+
+        /*!
+            \param[in] blocks The blocks to decrypt
+            \param[out] out Where to write the decrypted blocks; may be the same as blocks
+            \param[in] count Number of blocks
+            \param[in] schedule The round keys of the DES key
+        */
+        void decrypt(const uint64_t* blocks, uint64_t* out, size_t count, const key_schedule& schedule)
+        {
+            crypt_blocks(blocks, out, count, _internal::broadcast_key_planes(schedule), true);
+        }
+
+        /*!
+            \param[in] block The block to encrypt
+            \param[in] keys The 64-bit DES keys
+            \param[out] out Where to write the block encrypted with each key
+            \param[in] count Number of keys
+            \throws logic_error : A key does not pass the parity check
+        */
+        void encrypt(const uint64_t& block, const uint64_t* keys, uint64_t* out, size_t count)
+        {
+            crypt_keys(block, keys, out, count, false);
+        }
+
+        /*!
+            \param[in] block The block to decrypt
+            \param[in] keys The 64-bit DES keys
+            \param[out] out Where to write the block decrypted with each key
+            \param[in] count Number of keys
+            \throws logic_error : A key does not pass the parity check
+        */
+        void decrypt(const uint64_t& block, const uint64_t* keys, uint64_t* out, size_t count)
+        {
+            crypt_keys(block, keys, out, count, true);
+        }
+    
+        /*!
+            \param[in] blocks The blocks to encrypt
+            \param[out] out Where to write the encrypted blocks; may be the same as blocks
+            \param[in] count Number of blocks
+            \param[in] schedule The round keys of the three DES keys
+        */
+        void encrypt(const uint64_t* blocks, uint64_t* out, size_t count, const triple_key_schedule& schedule)
+        {
+            crypt_blocks(blocks, out, count, _internal::broadcast_key_planes(schedule), false);
+        }
+
+        /*!
+            \param[in] blocks The blocks to decrypt
+            \param[out] out Where to write the decrypted blocks; may be the same as blocks
+            \param[in] count Number of blocks
+            \param[in] schedule The round keys of the three DES keys
+        */
+        void decrypt(const uint64_t* blocks, uint64_t* out, size_t count, const triple_key_schedule& schedule)
+        {
+            crypt_blocks(blocks, out, count, _internal::broadcast_key_planes(schedule), true);
+        }
+    }
+}
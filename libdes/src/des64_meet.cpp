@@ -0,0 +1,317 @@
+#include "../headers/des64_meet.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+using namespace std;
+
+namespace des64
+{
+    namespace search
+    {
+        namespace
+        {
+            //! Largest number of entries in the table for one pass, so offsets fit in 32 bits
+            constexpr uint64_t MAX_PASS_ENTRIES = 1ULL << 32;
+
+            /*!
+                Runs tasks across threads, which take the next task in turn
+
+                Template arguments
+                    - class Work - Callable with the number of a task
+
+                \param[in] tasks Number of tasks
+                \param[in] workers Number of threads to run
+                \param[in] work The function to run for each task
+            */
+            template<class Work>
+            void parallel_tasks(uint64_t tasks, uint64_t workers, Work work)
+            {
+                workers = max<uint64_t>(1, min<uint64_t>(workers, tasks));
+
+                atomic<uint64_t> next(0);
+                vector<exception_ptr> errors(workers);
+                vector<thread> threads;
+                for(uint64_t w = 0; w < workers; w++)
+                {
+                    threads.emplace_back([&, w]()
+                    {
+                        try
+                        {
+                            for(uint64_t t = next++; t < tasks; t = next++)
+                                work(t);
+                        }
+                        catch(...)
+                        {
+                            errors[w] = current_exception();
+                        }
+                    });
+                }
+                for(thread& t : threads)
+                    t.join();
+
+                for(const exception_ptr& e : errors)
+                    if(e) rethrow_exception(e);
+            }
+
+            /*!
+                Encrypts or decrypts a block with every key of a range, 64 keys at a time,
+                in slices of SLICE indices spread across threads
+
+                Template arguments
+                    - class Found - Callable with an index and the result of its key
+
+                \param[in] block The block to encrypt or decrypt
+                \param[in] first The first index
+                \param[in] last One past the last index
+                \param[in] decrypt Whether to decrypt
+                \param[in] workers Number of threads to run
+                \param[in] found The function to call with each index and result
+            */
+            template<class Found>
+            void sweep(uint64_t block, uint64_t first, uint64_t last, bool decrypt, uint64_t workers, Found found)
+            {
+                _internal::planes broadcast;
+                for(int j = 0; j < 64; j++)
+                    broadcast[j] = 0 - ((block >> (63 - j)) & 1);
+
+                parallel_tasks((last - first + SLICE - 1) / SLICE, workers, [&](uint64_t s)
+                {
+                    const uint64_t low = first + s * SLICE, high = min(last, low + SLICE);
+                    for(uint64_t base = low & ~63ULL; base < high; base += 64)
+                    {
+                        _internal::planes data = broadcast;
+                        _internal::bitslice_crypt(data, _internal::key_planes(_internal::index_planes(base)), decrypt);
+                        _internal::transpose(data);
+
+                        for(uint64_t i = max(low, base); i < min(high, base + 64); i++)
+                            found(i, data[i - base]);
+                    }
+                });
+            }
+
+            /*! \brief Sorted table of the middle values \f$ E_{k_1}(P) \f$ for a range of first keys
+
+                Each entry is one 64-bit word: the high bits of the middle value, with the low
+                bits replaced by the offset of the key in the range. Entries are partitioned into
+                buckets by their top bits, and each bucket is sorted, so a lookup is one directory
+                read and a binary search of a few entries. Entries which share the high bits of a
+                middle value are candidates, and are checked in full by the caller.
+            */
+            class middle_table
+            {
+                public:
+                    /*!
+                        \param[in] plaintext The first known plaintext
+                        \param[in] first The index of the first key
+                        \param[in] count Number of keys, at most MAX_PASS_ENTRIES
+                        \param[in] workers Number of threads to run
+                    */
+                    middle_table(uint64_t plaintext, uint64_t first, uint64_t count, uint64_t workers) : _first(first)
+                    {
+                        const int bits = count > 1 ? 64 - __builtin_clzll(count - 1) : 1;
+                        _mask = (1ULL << bits) - 1;
+                        _depth = min(20, max(0, bits - 2));
+
+                        //Entries in order of key, to be partitioned into buckets
+                        vector<uint64_t> raw(count);
+                        sweep(plaintext, first, first + count, false, workers, [&](uint64_t index, uint64_t middle)
+                        {
+                            raw[index - first] = (middle & ~_mask) | (index - first);
+                        });
+
+                        //Each thread counts the buckets of its own part, then writes its entries after those of the parts before it
+                        const uint64_t parts = max<uint64_t>(1, min<uint64_t>(workers, count / 4096));
+                        const size_t buckets = size_t(1) << _depth;
+                        vector<vector<uint64_t>> counts(parts, vector<uint64_t>(buckets + 1, 0));
+                        auto part = [&](uint64_t p) { return make_pair(raw.begin() + p * count / parts, raw.begin() + (p + 1) * count / parts); };
+
+                        parallel_tasks(parts, workers, [&](uint64_t p)
+                        {
+                            for(auto it = part(p).first; it != part(p).second; it++)
+                                counts[p][bucket(*it) + 1]++;
+                        });
+
+                        _buckets.assign(buckets + 1, 0);
+                        uint64_t total = 0;
+                        for(size_t b = 0; b < buckets; b++)
+                        {
+                            _buckets[b] = total;
+                            for(uint64_t p = 0; p < parts; p++)
+                            {
+                                uint64_t n = counts[p][b + 1];
+                                counts[p][b] = total;
+                                total += n;
+                            }
+                        }
+                        _buckets[buckets] = total;
+
+                        _entries.resize(count);
+                        parallel_tasks(parts, workers, [&](uint64_t p)
+                        {
+                            for(auto it = part(p).first; it != part(p).second; it++)
+                                _entries[counts[p][bucket(*it)]++] = *it;
+                        });
+                        raw = vector<uint64_t>();
+
+                        const size_t group = 1024;
+                        parallel_tasks((buckets + group - 1) / group, workers, [&](uint64_t g)
+                        {
+                            for(size_t b = g * group; b < min(buckets, (g + 1) * group); b++)
+                                sort(_entries.begin() + _buckets[b], _entries.begin() + _buckets[b + 1]);
+                        });
+                    }
+
+                    /*!
+                        Template arguments
+                            - class Found - Callable with the index of a candidate first key
+
+                        \param[in] middle A middle value \f$ D_{k_2}(C) \f$
+                        \param[in] found The function to call with each candidate
+                    */
+                    template<class Found>
+                    void find(uint64_t middle, Found found) const
+                    {
+                        const uint64_t high = middle & ~_mask;
+                        const size_t b = bucket(middle);
+                        auto it = lower_bound(_entries.begin() + _buckets[b], _entries.begin() + _buckets[b + 1], high);
+                        for(; it != _entries.begin() + _buckets[b + 1] && (*it & ~_mask) == high; it++)
+                            found(_first + (*it & _mask));
+                    }
+
+                private:
+                    //! The bucket of an entry or middle value, from its top bits
+                    size_t bucket(uint64_t value) const
+                    {
+                        return _depth ? value >> (64 - _depth) : 0;
+                    }
+
+                    uint64_t _first;
+                    uint64_t _mask;
+                    int _depth;
+                    vector<uint64_t> _entries;
+                    vector<uint64_t> _buckets;
+            };
+
+            /*!
+                \param[in] range A range of key indices
+                \param[in] memory Bytes of memory for the table
+                \returns uint64_t - Number of first keys in the table of each pass
+                \throws logic_error : The range is not within the key space, or the memory does not fit one entry
+            */
+            uint64_t pass_entries(const index_range& range, size_t memory)
+            {
+                if(range.first > range.second || range.second > KEY_SPACE)
+                    throw logic_error("key range is not within the key space");
+                if(memory < MEET_ENTRY_BYTES)
+                    throw logic_error("not enough memory for a meet-in-the-middle table");
+
+                return min<uint64_t>(memory / MEET_ENTRY_BYTES, MAX_PASS_ENTRIES);
+            }
+        }
+
+        /*!
+            Each pass holds the middle values of part of the first key range and decrypts with
+            the whole second key range, so halving the memory doubles the decryptions.
+
+            \param[in] first The range of indices of the first key
+            \param[in] memory Bytes of memory for the table (Default MEET_MEMORY)
+            \returns uint64_t - The number of passes
+            \throws logic_error : The range is not within the key space, or the memory does not fit one entry
+        */
+        uint64_t meet_passes(const index_range& first, size_t memory)
+        {
+            const uint64_t entries = pass_entries(first, memory);
+            return (first.second - first.first + entries - 1) / entries;
+        }
+
+        /*!
+            Every pass but the last holds exactly as many keys as fit in memory, so each
+            boundary is a multiple of the pass size from the start of the range.
+
+            \param[in] first The range of indices of the first key
+            \param[in] pass The number of the pass, less than meet_passes()
+            \param[in] memory Bytes of memory for the table (Default MEET_MEMORY)
+            \returns index_range - The indices of the first keys in the table of the pass
+            \throws logic_error : The range is not within the key space, the memory does not fit one entry, or there is no such pass
+        */
+        index_range meet_pass_range(const index_range& first, uint64_t pass, size_t memory)
+        {
+            const uint64_t entries = pass_entries(first, memory);
+            if(pass >= meet_passes(first, memory))
+                throw logic_error("meet-in-the-middle pass is past the end of the range");
+
+            const uint64_t low = first.first + pass * entries;
+            return {low, min(first.second, low + entries)};
+        }
+
+        /*!
+            Double DES encrypts with \f$ k_1 \f$ then \f$ k_2 \f$, so \f$ E_{k_1}(P) = D_{k_2}(C) \f$. The middle
+            values \f$ E_{k_1}(P) \f$ of the first pair are put in a table, then \f$ D_{k_2}(C) \f$ is found for
+            every second key and looked up. Both directions use the bitsliced DES across threads.
+
+            When the table for the whole first range does not fit in memory, the range is split
+            into passes, and every pass decrypts with all of the second range again. Memory is
+            MEET_ENTRY_BYTES per first key in a pass, so the attack makes meet_passes() passes,
+            which cover the ranges given by meet_pass_range().
+
+            A 64-bit block cannot pin down 112 bits of key, so one pair matches about \f$ 2^{48} \f$ key
+            pairs over the full key space. Pass at least two pairs; candidates from the first pair
+            are checked against the rest.
+
+            \param[in] pairs Plaintexts with their ciphertexts under double DES
+            \param[in] first The range of indices of the first key (Default the whole key space)
+            \param[in] second The range of indices of the second key (Default the whole key space)
+            \param[in] memory Bytes of memory for the table (Default MEET_MEMORY)
+            \param[in] workers Number of threads to run (Default one per hardware core)
+            \returns vector<key_pair> - The keys which match every pair, with correct parity, sorted
+            \throws logic_error : There are no pairs, a range is not within the key space, or the memory does not fit one entry
+        */
+        vector<key_pair> meet_in_the_middle(const vector<known_pair>& pairs, const index_range& first, const index_range& second,
+                                            size_t memory, uint64_t workers)
+        {
+            if(pairs.empty())
+                throw logic_error("meet-in-the-middle needs at least one known pair");
+            pass_entries(second, memory);
+
+            const uint64_t passes = meet_passes(first, memory);
+            const uint64_t plaintext = pairs[0].first, ciphertext = pairs[0].second;
+
+            mutex found_lock;
+            vector<key_pair> found;
+            for(uint64_t p = 0; p < passes; p++)
+            {
+                const index_range range = meet_pass_range(first, p, memory);
+                const middle_table table(plaintext, range.first, range.second - range.first, workers);
+
+                sweep(ciphertext, second.first, second.second, true, workers, [&](uint64_t index, uint64_t middle)
+                {
+                    table.find(middle, [&](uint64_t candidate)
+                    {
+                        const key_schedule k1(key_at(candidate));
+                        if(encrypt(plaintext, k1) != middle)
+                            return;
+
+                        const key_schedule k2(key_at(index));
+                        bool all = all_of(pairs.begin() + 1, pairs.end(), [&](const known_pair& pair)
+                        {
+                            return encrypt(encrypt(pair.first, k1), k2) == pair.second;
+                        });
+
+                        if(all)
+                        {
+                            lock_guard<mutex> guard(found_lock);
+                            found.emplace_back(key_at(candidate), key_at(index));
+                        }
+                    });
+                });
+            }
+
+            sort(found.begin(), found.end());
+            return found;
+        }
+    }
+}
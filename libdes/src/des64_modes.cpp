@@ -0,0 +1,569 @@
+#include "../headers/des64_modes.h"
+#include "../headers/des64_bitslice.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+using namespace std;
+
+namespace des64
+{
+    namespace _internal
+    {
+        namespace
+        {
+            //! Number of blocks gathered for each call to the bitsliced DES
+            constexpr size_t CHUNK_BLOCKS = 1024;
+
+            /*!
+                \param[in] in Bytes to XOR
+                \param[out] out Where to write the result; may be the same as in
+                \param[in] keystream Block to XOR with, most significant byte first
+                \param[in] n Number of bytes, at most 8
+            */
+            inline void xor_bytes(const uint8_t* in, uint8_t* out, const uint64_t& keystream, size_t n)
+            {
+                for(size_t j = 0; j < n; j++)
+                    out[j] = in[j] ^ (uint8_t)(keystream >> (56 - 8*j));
+            }
+
+            /*!
+                \param[in] in Up to 8 bytes
+                \param[in] n Number of bytes
+                \returns uint64_t - The bytes as a block, with the missing bytes as 0
+            */
+            inline uint64_t load_partial(const uint8_t* in, size_t n)
+            {
+                uint64_t block = 0;
+                for(size_t j = 0; j < n; j++)
+                    block |= (uint64_t)in[j] << (56 - 8*j);
+
+                return block;
+            }
+
+            /*!
+                \param[in] mode The mode of operation
+                \param[in] length The length of the buffer in bytes
+                \throws logic_error : The mode needs whole blocks and length is not a multiple of 8
+            */
+            void check_length(Mode mode, size_t length)
+            {
+                if((mode == Mode::ECB || mode == Mode::CBC) && length % BLOCK_BYTES)
+                    throw logic_error("ECB and CBC need a whole number of blocks");
+            }
+
+            /*!
+                Processes a buffer in chunks, encrypting many blocks at once with
+                the bitsliced DES. The gather function fills the blocks to encrypt
+                for a chunk from the input, before any output of the chunk is written,
+                and the scatter function combines them with the input and writes the output.
+
+                \param[in] length The length of the buffer in bytes
+                \param[in] schedule The round keys
+                \param[in] decrypt Whether the chunks are decrypted rather than encrypted
+                \param[in] gather Called with (first block, number of blocks, blocks to fill)
+                \param[in] scatter Called with (first block, number of blocks, processed blocks)
+            */
+            template<class Schedule, class Gather, class Scatter>
+            void chunked(size_t length, const Schedule& schedule, bool decrypt, Gather gather, Scatter scatter)
+            {
+                const size_t blocks = (length + BLOCK_BYTES - 1) / BLOCK_BYTES;
+                array<uint64_t, CHUNK_BLOCKS> chunk;
+
+                for(size_t i = 0; i < blocks; i += CHUNK_BLOCKS)
+                {
+                    const size_t n = min(blocks - i, CHUNK_BLOCKS);
+                    gather(i, n, chunk.data());
+
+                    if(decrypt)
+                        bitslice::decrypt(chunk.data(), chunk.data(), n, schedule);
+                    else
+                        bitslice::encrypt(chunk.data(), chunk.data(), n, schedule);
+
+                    scatter(i, n, chunk.data());
+                }
+            }
+
+            /*!
+                XORs the input with a keystream computed many blocks at a time,
+                for CTR and CFB decryption
+
+                \param[in] in The input buffer
+                \param[out] out The output buffer; may be the same as in
+                \param[in] length The length of the buffer in bytes
+                \param[in] schedule The round keys
+                \param[in] gather Fills the blocks to encrypt into the keystream
+            */
+            template<class Schedule, class Gather>
+            void keystream(const uint8_t* in, uint8_t* out, size_t length, const Schedule& schedule, Gather gather)
+            {
+                chunked(length, schedule, false, gather, [&](size_t i, size_t n, const uint64_t* ks)
+                {
+                    for(size_t j = 0; j < n; j++)
+                    {
+                        size_t offset = (i + j) * BLOCK_BYTES;
+                        xor_bytes(in + offset, out + offset, ks[j], min(BLOCK_BYTES, length - offset));
+                    }
+                });
+            }
+
+            /*!
+                OFB and CTR are the same in both directions
+
+                \param[in] mode The mode of operation
+                \param[in] in The input buffer
+                \param[out] out The output buffer; may be the same as in
+                \param[in] length The length of the buffer in bytes
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR
+            */
+            template<class Schedule>
+            void stream(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const Schedule& schedule, const uint64_t& iv)
+            {
+                if(mode == Mode::CTR)
+                {
+                    keystream(in, out, length, schedule, [&](size_t i, size_t n, uint64_t* blocks)
+                    {
+                        for(size_t j = 0; j < n; j++)
+                            blocks[j] = iv + i + j;
+                    });
+                    return;
+                }
+
+                //OFB feeds each keystream block into the next, so it cannot be batched
+                uint64_t ks = iv;
+                for(size_t offset = 0; offset < length; offset += BLOCK_BYTES)
+                {
+                    ks = des64::encrypt(ks, schedule);
+                    xor_bytes(in + offset, out + offset, ks, min(BLOCK_BYTES, length - offset));
+                }
+            }
+
+            /*!
+                Shared by the single and triple DES overloads of encrypt()
+
+                Template arguments
+                    - class Schedule - key_schedule or triple_key_schedule
+
+                \param[in] mode The mode of operation
+                \param[in] in The plaintext
+                \param[out] out Where to write the ciphertext; may be the same as in
+                \param[in] length The length of the plaintext in bytes
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+                \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+            */
+            template<class Schedule>
+            void encrypt_mode(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const Schedule& schedule, const uint64_t& iv)
+            {
+                check_length(mode, length);
+
+                switch(mode)
+                {
+                    case Mode::ECB:
+                        chunked(length, schedule, false, [&](size_t i, size_t n, uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                blocks[j] = load_block(in + (i + j) * BLOCK_BYTES);
+                        }, [&](size_t i, size_t n, const uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                store_block(blocks[j], out + (i + j) * BLOCK_BYTES);
+                        });
+                        break;
+
+                    case Mode::CBC:
+                    {
+                        uint64_t last = iv;
+                        for(size_t offset = 0; offset < length; offset += BLOCK_BYTES)
+                        {
+                            last = des64::encrypt(load_block(in + offset) ^ last, schedule);
+                            store_block(last, out + offset);
+                        }
+                        break;
+                    }
+
+                    case Mode::CFB:
+                    {
+                        uint64_t last = iv;
+                        for(size_t offset = 0; offset < length; offset += BLOCK_BYTES)
+                        {
+                            size_t n = min(BLOCK_BYTES, length - offset);
+                            xor_bytes(in + offset, out + offset, des64::encrypt(last, schedule), n);
+                            last = load_partial(out + offset, n);
+                        }
+                        break;
+                    }
+
+                    default:
+                        stream(mode, in, out, length, schedule, iv);
+                }
+            }
+
+            /*!
+                Shared by the single and triple DES overloads of decrypt()
+
+                Template arguments
+                    - class Schedule - key_schedule or triple_key_schedule
+
+                \param[in] mode The mode of operation
+                \param[in] in The ciphertext
+                \param[out] out Where to write the plaintext; may be the same as in
+                \param[in] length The length of the ciphertext in bytes
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+                \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+            */
+            template<class Schedule>
+            void decrypt_mode(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const Schedule& schedule, const uint64_t& iv)
+            {
+                check_length(mode, length);
+
+                //The last ciphertext block of the previous chunk, read before it can be overwritten
+                uint64_t last = iv;
+                switch(mode)
+                {
+                    case Mode::ECB:
+                        chunked(length, schedule, true, [&](size_t i, size_t n, uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                blocks[j] = load_block(in + (i + j) * BLOCK_BYTES);
+                        }, [&](size_t i, size_t n, const uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                store_block(blocks[j], out + (i + j) * BLOCK_BYTES);
+                        });
+                        break;
+
+                    case Mode::CBC:
+                    {
+                        array<uint64_t, CHUNK_BLOCKS> cipher;
+                        chunked(length, schedule, true, [&](size_t i, size_t n, uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                blocks[j] = cipher[j] = load_block(in + (i + j) * BLOCK_BYTES);
+                        }, [&](size_t i, size_t n, const uint64_t* blocks)
+                        {
+                            for(size_t j = 0; j < n; j++)
+                                store_block(blocks[j] ^ (j ? cipher[j - 1] : last), out + (i + j) * BLOCK_BYTES);
+                            last = cipher[n - 1];
+                        });
+                        break;
+                    }
+
+                    case Mode::CFB:
+                        keystream(in, out, length, schedule, [&](size_t i, size_t n, uint64_t* blocks)
+                        {
+                            blocks[0] = last;
+                            for(size_t j = 1; j < n; j++)
+                                blocks[j] = load_block(in + (i + j - 1) * BLOCK_BYTES);
+
+                            //Only a full block can be fed into the next chunk
+                            size_t offset = (i + n - 1) * BLOCK_BYTES;
+                            if(length - offset >= BLOCK_BYTES)
+                                last = load_block(in + offset);
+                        });
+                        break;
+
+                    default:
+                        stream(mode, in, out, length, schedule, iv);
+                }
+            }
+
+            /*!
+                Splits a buffer into chunks which the workers take in turn, so
+                threads which finish early take more chunks. Each chunk is an
+                independent call to encrypt() or decrypt(), started from the
+                counter or ciphertext block just before it. Those are all read
+                before any thread writes, so the output may be the input.
+
+                Modes where each block depends on the output of the one before,
+                and buffers below PARALLEL_THRESHOLD, run on the calling thread.
+
+                \param[in] mode The mode of operation
+                \param[in] decrypting Whether to decrypt
+                \param[in] in The input buffer
+                \param[out] out The output buffer; may be the same as in
+                \param[in] length The length of the buffer in bytes
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR
+                \param[in] chunk Bytes per chunk, rounded down to whole blocks
+                \param[in] workers Number of threads to run
+                \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+            */
+            template<class Schedule>
+            void parallel(Mode mode, bool decrypting, const uint8_t* in, uint8_t* out, size_t length, const Schedule& schedule,
+                          const uint64_t& iv, size_t chunk, uint64_t workers)
+            {
+                check_length(mode, length);
+
+                chunk = max(BLOCK_BYTES, chunk - chunk % BLOCK_BYTES);
+                const size_t chunks = (length + chunk - 1) / chunk;
+                workers = max<uint64_t>(1, min<uint64_t>(workers, chunks));
+
+                const bool independent = mode == Mode::ECB || mode == Mode::CTR ||
+                                         (decrypting && (mode == Mode::CBC || mode == Mode::CFB));
+                if(length < PARALLEL_THRESHOLD || workers == 1 || !independent)
+                {
+                    if(decrypting)
+                        decrypt_mode(mode, in, out, length, schedule, iv);
+                    else
+                        encrypt_mode(mode, in, out, length, schedule, iv);
+                    return;
+                }
+
+                vector<uint64_t> starts(chunks);
+                for(size_t c = 0; c < chunks; c++)
+                {
+                    size_t offset = c * chunk;
+                    if(mode == Mode::CTR)
+                        starts[c] = iv + offset / BLOCK_BYTES;
+                    else
+                        starts[c] = c ? load_block(in + offset - BLOCK_BYTES) : iv;
+                }
+
+                atomic<size_t> next(0);
+                vector<exception_ptr> errors(workers);
+                vector<thread> threads;
+                for(uint64_t w = 0; w < workers; w++)
+                {
+                    threads.emplace_back([&, w]()
+                    {
+                        try
+                        {
+                            for(size_t c = next++; c < chunks; c = next++)
+                            {
+                                size_t offset = c * chunk, n = min(chunk, length - offset);
+                                if(decrypting)
+                                    decrypt_mode(mode, in + offset, out + offset, n, schedule, starts[c]);
+                                else
+                                    encrypt_mode(mode, in + offset, out + offset, n, schedule, starts[c]);
+                            }
+                        }
+                        catch(...)
+                        {
+                            errors[w] = current_exception();
+                        }
+                    });
+                }
+                for(thread& t : threads)
+                    t.join();
+
+                for(const exception_ptr& e : errors)
+                    if(e) rethrow_exception(e);
+            }
+        }
+    }
+
+    /*!
+        \param[in] in 8 bytes
+        \returns uint64_t - The block, read big-endian regardless of the host
+    */
+    uint64_t load_block(const uint8_t* in)
+    {
+        return _internal::load_partial(in, BLOCK_BYTES);
+    }
+
+    /*!
+        \param[in] block The block to write
+        \param[out] out Where to write 8 bytes, big-endian regardless of the host
+    */
+    void store_block(const uint64_t& block, uint8_t* out)
+    {
+        for(size_t j = 0; j < BLOCK_BYTES; j++)
+            out[j] = (uint8_t)(block >> (56 - 8*j));
+    }
+
+    /*!
+        The key schedule is computed once by the caller and used for every block.
+        ECB, CTR and the keystream of CFB decryption are independent for each
+        block, so they use the bitsliced DES. CBC and CFB encryption, and OFB,
+        depend on the previous block, so they encrypt one block at a time.
+
+        \param[in] mode The mode of operation
+        \param[in] in The plaintext
+        \param[out] out Where to write the ciphertext; may be the same as in
+        \param[in] length The length of the plaintext in bytes
+        \param[in] schedule The round keys of the DES key
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void encrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv)
+    {
+        _internal::encrypt_mode(mode, in, out, length, schedule, iv);
+    }
+
+    /*!
+        Each block passes through the three stages of triple DES, batched
+        through the bitsliced DES in the same modes as single DES.
+
+        \param[in] mode The mode of operation
+        \param[in] in The plaintext
+        \param[out] out Where to write the ciphertext; may be the same as in
+        \param[in] length The length of the plaintext in bytes
+        \param[in] schedule The round keys of the three DES keys
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void encrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv)
+    {
+        _internal::encrypt_mode(mode, in, out, length, schedule, iv);
+    }
+
+    /*!
+        \param[in] mode The mode of operation
+        \param[in] in The ciphertext
+        \param[out] out Where to write the plaintext; may be the same as in
+        \param[in] length The length of the ciphertext in bytes
+        \param[in] schedule The round keys of the DES key
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void decrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv)
+    {
+        _internal::decrypt_mode(mode, in, out, length, schedule, iv);
+    }
+
+    /*!
+        \param[in] mode The mode of operation
+        \param[in] in The ciphertext
+        \param[out] out Where to write the plaintext; may be the same as in
+        \param[in] length The length of the ciphertext in bytes
+        \param[in] schedule The round keys of the three DES keys
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void decrypt(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv)
+    {
+        _internal::decrypt_mode(mode, in, out, length, schedule, iv);
+    }
+
+    /*!
+        ECB and CTR are split across threads. CBC, CFB and OFB encryption
+        chain every block, so they run on the calling thread.
+
+        \param[in] mode The mode of operation
+        \param[in] in The plaintext
+        \param[out] out Where to write the ciphertext; may be the same as in
+        \param[in] length The length of the plaintext in bytes
+        \param[in] schedule The round keys of the DES key
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \param[in] chunk Bytes each thread processes at a time (Default PARALLEL_CHUNK)
+        \param[in] workers Number of threads to run (Default one per hardware core)
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void encrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv,
+                          size_t chunk, uint64_t workers)
+    {
+        _internal::parallel(mode, false, in, out, length, schedule, iv, chunk, workers);
+    }
+
+    /*!
+        Splits triple DES across threads in the same way as single DES.
+
+        \param[in] mode The mode of operation
+        \param[in] in The plaintext
+        \param[out] out Where to write the ciphertext; may be the same as in
+        \param[in] length The length of the plaintext in bytes
+        \param[in] schedule The round keys of the three DES keys
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \param[in] chunk Bytes each thread processes at a time (Default PARALLEL_CHUNK)
+        \param[in] workers Number of threads to run (Default one per hardware core)
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void encrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv,
+                          size_t chunk, uint64_t workers)
+    {
+        _internal::parallel(mode, false, in, out, length, schedule, iv, chunk, workers);
+    }
+
+    /*!
+        ECB, CBC, CFB and CTR are split across threads, since each block only
+        needs the ciphertext before it. OFB runs on the calling thread.
+
+        \param[in] mode The mode of operation
+        \param[in] in The ciphertext
+        \param[out] out Where to write the plaintext; may be the same as in
+        \param[in] length The length of the ciphertext in bytes
+        \param[in] schedule The round keys of the DES key
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \param[in] chunk Bytes each thread processes at a time (Default PARALLEL_CHUNK)
+        \param[in] workers Number of threads to run (Default one per hardware core)
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void decrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const key_schedule& schedule, const uint64_t& iv,
+                          size_t chunk, uint64_t workers)
+    {
+        _internal::parallel(mode, true, in, out, length, schedule, iv, chunk, workers);
+    }
+
+    /*!
+        Splits triple DES across threads in the same way as single DES.
+
+        \param[in] mode The mode of operation
+        \param[in] in The ciphertext
+        \param[out] out Where to write the plaintext; may be the same as in
+        \param[in] length The length of the ciphertext in bytes
+        \param[in] schedule The round keys of the three DES keys
+        \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+        \param[in] chunk Bytes each thread processes at a time (Default PARALLEL_CHUNK)
+        \param[in] workers Number of threads to run (Default one per hardware core)
+        \throws logic_error : ECB or CBC with a length which is not a multiple of 8
+    */
+    void decrypt_parallel(Mode mode, const uint8_t* in, uint8_t* out, size_t length, const triple_key_schedule& schedule, const uint64_t& iv,
+                          size_t chunk, uint64_t workers)
+    {
+        _internal::parallel(mode, true, in, out, length, schedule, iv, chunk, workers);
+    }
+
+    /*!
+        \param[in] length The length of the buffer in bytes
+        \returns size_t - The next multiple of 8 strictly greater than length
+    */
+    size_t pkcs7_length(size_t length)
+    {
+        return length + BLOCK_BYTES - length % BLOCK_BYTES;
+    }
+
+    /*!
+        Appends between 1 and 8 bytes, each equal to the number of bytes appended
+
+        \param[in, out] buffer The buffer to pad, with room for pkcs7_length(length) bytes
+        \param[in] length The length of the data in the buffer
+        \returns size_t - The length after padding
+    */
+    size_t pkcs7_pad(uint8_t* buffer, size_t length)
+    {
+        size_t padded = pkcs7_length(length);
+        fill(buffer + length, buffer + padded, (uint8_t)(padded - length));
+
+        return padded;
+    }
+
+    /*!
+        \param[in] buffer The padded data
+        \param[in] length The length of the padded data
+        \returns size_t - The length of the data without padding
+        \throws logic_error : The padding is not valid PKCS#7
+    */
+    size_t pkcs7_unpad(const uint8_t* buffer, size_t length)
+    {
+        if(length == 0 || length % BLOCK_BYTES)
+            throw logic_error("padded length is not a whole number of blocks");
+
+        uint8_t pad = buffer[length - 1];
+        if(pad == 0 || pad > BLOCK_BYTES)
+            throw logic_error("invalid padding");
+
+        for(size_t j = length - pad; j < length; j++)
+            if(buffer[j] != pad)
+                throw logic_error("invalid padding");
+
+        return length - pad;
+    }
+}
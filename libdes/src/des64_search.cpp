@@ -0,0 +1,240 @@
+#include "../headers/des64_search.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <exception>
+
+using namespace std;
+
+namespace des64
+{
+    namespace _internal
+    {
+        namespace
+        {
+            /*!
+                Plane of lanes whose index has each of the lowest 6 bits set. With a batch of
+                64 indices starting at a multiple of 64, these bits are the only ones which differ
+                between lanes.
+
+                \returns array<uint64_t, 6> - Entry t has lane i set when bit t of i is set
+            */
+            constexpr array<uint64_t, 6> make_lane_bits()
+            {
+                array<uint64_t, 6> out{};
+                for(int t = 0; t < 6; t++)
+                    for(int i = 0; i < 64; i++)
+                        if((i >> t) & 1)
+                            out[t] |= 1ULL << (63 - i);
+
+                return out;
+            }
+
+            //! Which lanes have each of the lowest 6 bits of their index set
+            constexpr array<uint64_t, 6> LANE_BITS = make_lane_bits();
+        }
+
+        /*!
+            Builds the key planes straight from the index, since key_at() only places the
+            bits of the index; the parity bits are not used by the key schedule.
+
+            \param[in] base The index of lane 0, a multiple of 64
+            \returns planes - The bit planes of the keys of the 64 indices from base
+        */
+        planes index_planes(uint64_t base)
+        {
+            planes keys{};
+            for(int t = 0; t < 56; t++)
+            {
+                int bit = t / 7 * 8 + 1 + t % 7;
+                keys[63 - bit] = t < 6 ? LANE_BITS[t] : 0 - ((base >> t) & 1);
+            }
+
+            return keys;
+        }
+
+        /*!
+            Lane i is bit (63 - i) of the mask, so the lowest set bit is the highest lane
+
+            \param[in] match The mask of lanes, as given by bitslice_match()
+            \param[in] base The index of lane 0, a multiple of 64
+            \param[in] low The first index to keep
+            \param[in] high One past the last index to keep
+            \returns vector<uint64_t> - The indices of the set lanes within [low, high), in increasing order
+        */
+        vector<uint64_t> match_indices(uint64_t match, uint64_t base, uint64_t low, uint64_t high)
+        {
+            vector<uint64_t> out;
+            for(; match; match &= match - 1)
+            {
+                const uint64_t index = base + 63 - __builtin_ctzll(match);
+                if(index >= low && index < high)
+                    out.push_back(index);
+            }
+            reverse(out.begin(), out.end());
+
+            return out;
+        }
+    }
+
+    namespace search
+    {
+        namespace
+        {
+            /*!
+                \param[in] pairs The known pairs
+                \param[in] first The first index to search
+                \param[in] last One past the last index to search
+                \throws logic_error : There are no pairs, or the range is not within the key space
+            */
+            void check_search(const vector<known_pair>& pairs, uint64_t first, uint64_t last)
+            {
+                if(pairs.empty())
+                    throw logic_error("key search needs at least one known pair");
+                if(first > last || last > KEY_SPACE)
+                    throw logic_error("key search range is not within the key space");
+            }
+        }
+
+        /*!
+            The keys are written in hexadecimal after the two indices and the number of keys
+
+            \param[in] out The stream to write to
+            \param[in] state The checkpoint
+            \returns ostream& - The stream
+        */
+        ostream& operator<<(ostream& out, const checkpoint& state)
+        {
+            auto flags = out.flags();
+            out << dec << state.next << ' ' << state.last << ' ' << state.keys.size() << hex;
+            for(uint64_t key : state.keys)
+                out << ' ' << key;
+            out.flags(flags);
+
+            return out;
+        }
+
+        /*!
+            \param[in] in The stream to read from
+            \param[out] state The checkpoint
+            \returns istream& - The stream, with failbit set if the checkpoint could not be read
+        */
+        istream& operator>>(istream& in, checkpoint& state)
+        {
+            auto flags = in.flags();
+            size_t count;
+            in >> dec >> state.next >> state.last >> count >> hex;
+
+            state.keys.clear();
+            for(uint64_t key; count && in >> key; count--)
+                state.keys.push_back(key);
+            in.flags(flags);
+
+            return in;
+        }
+
+        /*!
+            \param[in] pairs Plaintexts with their ciphertexts under the key being searched for
+            \param[in] first The first index to search (Default 0)
+            \param[in] last One past the last index to search (Default KEY_SPACE)
+            \throws logic_error : There are no pairs, or the range is not within the key space
+        */
+        key_search::key_search(const vector<known_pair>& pairs, uint64_t first, uint64_t last) :
+            _pairs(pairs), _next(first), _last(last)
+        {
+            check_search(pairs, first, last);
+        }
+
+        /*!
+            The pairs must be the same as those of the saved search
+
+            \param[in] pairs Plaintexts with their ciphertexts under the key being searched for
+            \param[in] resume The state of the saved search
+            \throws logic_error : There are no pairs, or the range is not within the key space
+        */
+        key_search::key_search(const vector<known_pair>& pairs, const checkpoint& resume) :
+            _pairs(pairs), _next(resume.next), _last(resume.last), _keys(resume.keys)
+        {
+            check_search(pairs, _next, _last);
+        }
+
+        /*!
+            Workers take slices of SLICE indices in turn. Every slice is finished before
+            returning, so everything before next() has been searched, and a checkpoint saved
+            afterwards loses no work.
+
+            \param[in] count Number of indices to search, or all that are left (Default the whole key space)
+            \param[in] workers Number of threads to run (Default one per hardware core)
+            \returns uint64_t - Number of indices searched
+        */
+        uint64_t key_search::run(uint64_t count, uint64_t workers)
+        {
+            const uint64_t first = _next, end = first + min(count, _last - first);
+            const uint64_t slices = (end - first + SLICE - 1) / SLICE;
+            workers = max<uint64_t>(1, min<uint64_t>(workers, slices));
+
+            const uint64_t plaintext = _pairs[0].first, ciphertext = _pairs[0].second;
+            auto start = chrono::steady_clock::now();
+
+            atomic<uint64_t> next(0);
+            mutex found_lock;
+            vector<uint64_t> found;
+            vector<exception_ptr> errors(workers);
+            vector<thread> threads;
+            for(uint64_t w = 0; w < workers; w++)
+            {
+                threads.emplace_back([&, w]()
+                {
+                    try
+                    {
+                        for(uint64_t s = next++; s < slices; s = next++)
+                        {
+                            const uint64_t low = first + s * SLICE, high = min(end, low + SLICE);
+                            for(uint64_t base = low & ~63ULL; base < high; base += 64)
+                            {
+                                const uint64_t match = _internal::bitslice_match(plaintext, ciphertext, _internal::key_planes(_internal::index_planes(base)));
+                                for(uint64_t index : _internal::match_indices(match, base, low, high))
+                                {
+                                    const key_schedule schedule(key_at(index));
+                                    bool all = all_of(_pairs.begin() + 1, _pairs.end(), [&](const known_pair& p)
+                                    {
+                                        return encrypt(p.first, schedule) == p.second;
+                                    });
+
+                                    if(all)
+                                    {
+                                        lock_guard<mutex> guard(found_lock);
+                                        found.push_back(index);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    catch(...)
+                    {
+                        errors[w] = current_exception();
+                    }
+                });
+            }
+            for(thread& t : threads)
+                t.join();
+
+            for(const exception_ptr& e : errors)
+                if(e) rethrow_exception(e);
+
+            sort(found.begin(), found.end());
+            for(uint64_t index : found)
+                _keys.push_back(key_at(index));
+
+            _next = end;
+            _searched += end - first;
+            _seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+            return end - first;
+        }
+    }
+}
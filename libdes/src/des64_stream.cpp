@@ -0,0 +1,448 @@
+#include "../headers/des64_stream.h"
+
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace des64
+{
+    namespace _internal
+    {
+        namespace
+        {
+            //! Closes a file descriptor when it goes out of scope
+            struct file_descriptor
+            {
+                int fd;
+
+                /*!
+                    \param[in] path The file to open
+                    \param[in] flags Flags for open()
+                    \throws system_error : The file cannot be opened
+                */
+                file_descriptor(const string& path, int flags) : fd(open(path.c_str(), flags, 0644))
+                {
+                    if(fd < 0)
+                        throw system_error(errno, generic_category(), "cannot open " + path);
+                }
+
+                ~file_descriptor()
+                {
+                    close(fd);
+                }
+            };
+
+            //! Unmaps a memory mapping when it goes out of scope
+            struct mapping
+            {
+                void* address = MAP_FAILED;
+                size_t length = 0;
+
+                ~mapping()
+                {
+                    if(address != MAP_FAILED)
+                        munmap(address, length);
+                }
+            };
+
+            /*!
+                \param[in] fd The file descriptor to write to
+                \param[in] buffer The bytes to write
+                \param[in] length The number of bytes
+                \throws system_error : The write fails
+            */
+            void write_all(int fd, const uint8_t* buffer, size_t length)
+            {
+                while(length)
+                {
+                    ssize_t n = write(fd, buffer, length);
+                    if(n < 0)
+                    {
+                        if(errno == EINTR)
+                            continue;
+                        throw system_error(errno, generic_category(), "write failed");
+                    }
+
+                    buffer += n;
+                    length -= n;
+                }
+            }
+
+            /*!
+                Keeps reading until the buffer is full, since pipes return whatever is available
+
+                \param[in] fd The file descriptor to read from
+                \param[out] buffer Where to store the bytes
+                \param[in] length The number of bytes wanted
+                \returns size_t - The number of bytes read, which is only less than length at the end of the input
+                \throws system_error : The read fails
+            */
+            size_t read_full(int fd, uint8_t* buffer, size_t length)
+            {
+                size_t total = 0;
+                while(total < length)
+                {
+                    ssize_t n = read(fd, buffer + total, length - total);
+                    if(n < 0)
+                    {
+                        if(errno == EINTR)
+                            continue;
+                        throw system_error(errno, generic_category(), "read failed");
+                    }
+                    if(n == 0)
+                        break;
+
+                    total += n;
+                }
+
+                return total;
+            }
+
+            /*!
+                Runs a mode of operation over consecutive chunks, as if they were one buffer.
+                Every chunk but the last must be a whole number of blocks.
+            */
+            template<class Schedule>
+            class chained
+            {
+                public:
+                    chained(Mode mode, bool decrypt, const Schedule& schedule, const uint64_t& iv) :
+                        _mode(mode), _decrypt(decrypt), _schedule(schedule), _iv(iv) {}
+
+                    /*!
+                        \param[in] in The next chunk of input
+                        \param[out] out Where to write the next chunk of output; may be the same as in
+                        \param[in] length The length of the chunk in bytes
+                    */
+                    void operator()(const uint8_t* in, uint8_t* out, size_t length)
+                    {
+                        if(length < BLOCK_BYTES)
+                        {
+                            process(in, out, length);
+                            return;
+                        }
+
+                        //The chaining value comes from the last whole block, read before it can be overwritten
+                        const size_t last = length - length % BLOCK_BYTES - BLOCK_BYTES;
+                        const uint64_t last_in = load_block(in + last);
+                        process(in, out, length);
+                        const uint64_t last_out = load_block(out + last);
+
+                        switch(_mode)
+                        {
+                            case Mode::CBC:
+                            case Mode::CFB:
+                                _iv = _decrypt ? last_in : last_out;
+                                break;
+                            case Mode::OFB:
+                                _iv = last_in ^ last_out;
+                                break;
+                            case Mode::CTR:
+                                _iv += length / BLOCK_BYTES;
+                                break;
+                            default:
+                                break;
+                        }
+                    }
+
+                private:
+                    void process(const uint8_t* in, uint8_t* out, size_t length)
+                    {
+                        if(_decrypt)
+                            decrypt_parallel(_mode, in, out, length, _schedule, _iv);
+                        else
+                            encrypt_parallel(_mode, in, out, length, _schedule, _iv);
+                    }
+
+                    Mode _mode;
+                    bool _decrypt;
+                    const Schedule& _schedule;
+                    uint64_t _iv;
+            };
+
+            /*!
+                Maps the rest of a regular file into memory, from the current offset of the descriptor
+
+                \param[in] fd The file descriptor
+                \param[out] map The mapping
+                \param[out] data The first byte after the current offset
+                \param[out] length The number of bytes after the current offset
+                \returns bool - Whether the file was mapped. If not, it should be read instead
+            */
+            bool map_input(int fd, mapping& map, const uint8_t*& data, size_t& length)
+            {
+                struct stat info;
+                if(fstat(fd, &info) || !S_ISREG(info.st_mode))
+                    return false;
+
+                off_t offset = lseek(fd, 0, SEEK_CUR);
+                if(offset < 0 || offset >= info.st_size)
+                    return false;
+
+                //Mappings start on a page boundary
+                const off_t start = offset - offset % sysconf(_SC_PAGESIZE);
+                map.length = info.st_size - start;
+                map.address = mmap(nullptr, map.length, PROT_READ, MAP_PRIVATE, fd, start);
+                if(map.address == MAP_FAILED)
+                    return false;
+
+                madvise(map.address, map.length, MADV_SEQUENTIAL);
+                data = (const uint8_t*)map.address + (offset - start);
+                length = info.st_size - offset;
+                lseek(fd, info.st_size, SEEK_SET);
+
+                return true;
+            }
+
+            /*!
+                Encrypts or decrypts a chunk at a time. A mapped input is read straight from the
+                mapping into the output buffer; otherwise each chunk is read into the output buffer
+                and processed in place. When decrypting ECB or CBC, the last block of each chunk is
+                held back until the next, since only the last block of the input holds the padding.
+
+                \param[in] mode The mode of operation
+                \param[in] decrypt Whether the input is decrypted rather than encrypted
+                \param[in] in The file descriptor to read from
+                \param[in] out The file descriptor to write to
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR
+                \param[in] chunk Bytes per chunk, rounded down to whole blocks
+                \returns uint64_t - The number of bytes written
+                \throws logic_error : The ciphertext of ECB or CBC is not a whole number of blocks, or has invalid padding
+                \throws system_error : Reading or writing fails
+            */
+            template<class Schedule>
+            uint64_t run(Mode mode, bool decrypt, int in, int out, const Schedule& schedule, const uint64_t& iv, size_t chunk)
+            {
+                chunk = max(BLOCK_BYTES, chunk - chunk % BLOCK_BYTES);
+                const bool padded = mode == Mode::ECB || mode == Mode::CBC;
+                chained<Schedule> cipher(mode, decrypt, schedule, iv);
+
+                mapping map;
+                const uint8_t* mapped = nullptr;
+                size_t remaining = 0;
+                const bool is_mapped = map_input(in, map, mapped, remaining);
+
+                //One block in front for a held back block, and one after for padding
+                vector<uint8_t> buffer(chunk + 2 * BLOCK_BYTES);
+                uint8_t* const data = buffer.data() + BLOCK_BYTES;
+                bool held = false;
+                uint64_t written = 0;
+
+                for(bool last = false; !last;)
+                {
+                    const uint8_t* source = data;
+                    size_t length;
+                    if(is_mapped)
+                    {
+                        source = mapped;
+                        length = min(chunk, remaining);
+                        mapped += length;
+                        remaining -= length;
+                        last = remaining == 0;
+                    }
+                    else
+                    {
+                        length = read_full(in, data, chunk);
+                        last = length < chunk;
+                    }
+
+                    if(padded && !decrypt && last)
+                    {
+                        const size_t whole = length - length % BLOCK_BYTES;
+                        cipher(source, data, whole);
+                        memmove(data + whole, source + whole, length - whole);
+                        length = whole + pkcs7_pad(data + whole, length - whole);
+                        cipher(data + whole, data + whole, BLOCK_BYTES);
+                    }
+                    else
+                        cipher(source, data, length);
+
+                    uint8_t* start = data;
+                    const bool hold = padded && decrypt && !last;
+                    if(padded && decrypt)
+                    {
+                        if(held)
+                        {
+                            start -= BLOCK_BYTES;
+                            length += BLOCK_BYTES;
+                        }
+
+                        length = last ? pkcs7_unpad(start, length) : length - BLOCK_BYTES;
+                    }
+
+                    write_all(out, start, length);
+                    written += length;
+
+                    if(hold)
+                    {
+                        memcpy(buffer.data(), start + length, BLOCK_BYTES);
+                        held = true;
+                    }
+                }
+
+                return written;
+            }
+
+            /*!
+                \param[in] mode The mode of operation
+                \param[in] decrypt Whether the input is decrypted rather than encrypted
+                \param[in] in The path to read from
+                \param[in] out The path to write to, which is created or truncated
+                \param[in] schedule The round keys
+                \param[in] iv The initialization vector, or the first counter for CTR
+                \param[in] chunk Bytes per chunk
+                \returns uint64_t - The number of bytes written
+            */
+            template<class Schedule>
+            uint64_t run(Mode mode, bool decrypt, const string& in, const string& out, const Schedule& schedule, const uint64_t& iv, size_t chunk)
+            {
+                file_descriptor input(in, O_RDONLY);
+                file_descriptor output(out, O_WRONLY | O_CREAT | O_TRUNC);
+
+                return run(mode, decrypt, input.fd, output.fd, schedule, iv, chunk);
+            }
+        }
+    }
+
+    namespace stream
+    {
+        /*!
+            Reads until the end of the input, so a pipe is read until the writer closes it.
+            Each chunk may be split across threads as in encrypt_parallel().
+
+            \param[in] mode The mode of operation
+            \param[in] in The file descriptor of the plaintext
+            \param[in] out The file descriptor to write the ciphertext to
+            \param[in] schedule The round keys of the DES key
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes encrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of ciphertext written
+            \throws system_error : Reading or writing fails
+        */
+        uint64_t encrypt(Mode mode, int in, int out, const key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, false, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The file descriptor of the plaintext
+            \param[in] out The file descriptor to write the ciphertext to
+            \param[in] schedule The round keys of the three DES keys
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes encrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of ciphertext written
+            \throws system_error : Reading or writing fails
+        */
+        uint64_t encrypt(Mode mode, int in, int out, const triple_key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, false, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The file descriptor of the ciphertext
+            \param[in] out The file descriptor to write the plaintext to
+            \param[in] schedule The round keys of the DES key
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes decrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of plaintext written
+            \throws logic_error : ECB or CBC ciphertext which is not a whole number of blocks or has invalid padding.
+            Everything before the last chunk has already been written
+            \throws system_error : Reading or writing fails
+        */
+        uint64_t decrypt(Mode mode, int in, int out, const key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, true, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The file descriptor of the ciphertext
+            \param[in] out The file descriptor to write the plaintext to
+            \param[in] schedule The round keys of the three DES keys
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes decrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of plaintext written
+            \throws logic_error : ECB or CBC ciphertext which is not a whole number of blocks or has invalid padding
+            \throws system_error : Reading or writing fails
+        */
+        uint64_t decrypt(Mode mode, int in, int out, const triple_key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, true, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The path of the plaintext
+            \param[in] out The path to write the ciphertext to, which is created or truncated
+            \param[in] schedule The round keys of the DES key
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes encrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of ciphertext written
+            \throws system_error : Either file cannot be opened, or reading or writing fails
+        */
+        uint64_t encrypt(Mode mode, const string& in, const string& out, const key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, false, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The path of the plaintext
+            \param[in] out The path to write the ciphertext to, which is created or truncated
+            \param[in] schedule The round keys of the three DES keys
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes encrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of ciphertext written
+            \throws system_error : Either file cannot be opened, or reading or writing fails
+        */
+        uint64_t encrypt(Mode mode, const string& in, const string& out, const triple_key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, false, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The path of the ciphertext
+            \param[in] out The path to write the plaintext to, which is created or truncated
+            \param[in] schedule The round keys of the DES key
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes decrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of plaintext written
+            \throws logic_error : ECB or CBC ciphertext which is not a whole number of blocks or has invalid padding
+            \throws system_error : Either file cannot be opened, or reading or writing fails
+        */
+        uint64_t decrypt(Mode mode, const string& in, const string& out, const key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, true, in, out, schedule, iv, chunk);
+        }
+
+        /*!
+            \param[in] mode The mode of operation
+            \param[in] in The path of the ciphertext
+            \param[in] out The path to write the plaintext to, which is created or truncated
+            \param[in] schedule The round keys of the three DES keys
+            \param[in] iv The initialization vector, or the first counter for CTR. Not used by ECB
+            \param[in] chunk Bytes decrypted between writes, rounded down to whole blocks (Default STREAM_CHUNK)
+            \returns uint64_t - The number of bytes of plaintext written
+            \throws logic_error : ECB or CBC ciphertext which is not a whole number of blocks or has invalid padding
+            \throws system_error : Either file cannot be opened, or reading or writing fails
+        */
+        uint64_t decrypt(Mode mode, const string& in, const string& out, const triple_key_schedule& schedule, const uint64_t& iv, size_t chunk)
+        {
+            return _internal::run(mode, true, in, out, schedule, iv, chunk);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "cryptomath.h"
+
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace cryptomath;
+
+/*!
+    \test Tests the batch primality functions with every supported kernel
+        - powMod matches the scalar powMod, for odd and even moduli
+        - millerRabin matches the scalar kernel, passes all primes, and handles small values and witnesses which are multiples of the value
+        - isPrime matches isPrime for random values, Carmichael numbers, and strong pseudoprimes to base 2
+        - Throws on a modulus of 0
+*/
+TEST_CASE("The batch primality functions")
+{
+    mt19937 reng(4);
+    const size_t COUNT = 1003;
+
+    vector<batch::Kernel> kernels{batch::Kernel::Scalar};
+    if(batch::supported(batch::Kernel::AVX2))
+        kernels.push_back(batch::Kernel::AVX2);
+
+    for(const batch::Kernel& k : kernels)
+    {
+        SECTION("PowMod")
+        {
+            vector<uint32_t> a(COUNT), b(COUNT), n(COUNT), out(COUNT);
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                a[i] = reng();
+                b[i] = reng() >> (reng() % 32);
+                n[i] = (i % 50 == 0) ? (reng() | 1) - 1 + 2 * (i % 100 == 0) : reng() | 1;
+                n[i] = n[i] ? n[i] : 1;
+            }
+            n[1] = 1;
+            n[2] = 0xFFFFFFFF;
+            batch::powMod(a.data(), b.data(), n.data(), out.data(), COUNT, k);
+
+            for(size_t i = 0; i < COUNT; i++)
+                REQUIRE(out[i] == powMod<uint64_t>(a[i], b[i], n[i]));
+
+            n[3] = 0;
+            REQUIRE_THROWS(batch::powMod(a.data(), b.data(), n.data(), out.data(), COUNT, k));
+        };
+
+        SECTION("Miller-Rabin")
+        {
+            vector<uint32_t> n(COUNT), a(COUNT);
+            vector<uint8_t> out(COUNT);
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                n[i] = (i < 64) ? i : reng();
+                a[i] = (i % 7 == 0) ? n[i] * (i % 3) : reng();
+            }
+            n[64] = 2047;
+            a[64] = 2;
+            n[65] = 2047;
+            a[65] = 3;
+
+            vector<uint8_t> expected(COUNT);
+            batch::millerRabin(n.data(), a.data(), out.data(), COUNT, k);
+            batch::millerRabin(n.data(), a.data(), expected.data(), COUNT, batch::Kernel::Scalar);
+
+            REQUIRE(out == expected);
+            REQUIRE(out[64] == 1);
+            REQUIRE(out[65] == 0);
+            for(size_t i = 0; i < COUNT; i++)
+            {
+                if(n[i] == 2 || n[i] == 3) REQUIRE(out[i] == 1);
+                else if(n[i] < 5 || n[i] % 2 == 0) REQUIRE(out[i] == 0);
+                else if(a[i] % n[i] == 0) REQUIRE(out[i] == 1);
+                else if(isPrime<uint64_t>(n[i])) REQUIRE(out[i] == 1);
+            }
+        };
+
+        SECTION("IsPrime")
+        {
+            vector<uint32_t> n(COUNT);
+            vector<uint8_t> out(COUNT);
+            for(size_t i = 0; i < COUNT; i++)
+                n[i] = (i < 100) ? i : reng() | 1;
+
+            //Carmichael numbers and strong pseudoprimes to base 2
+            vector<uint32_t> pseudo{561, 1105, 41041, 825265, 2047, 3277, 4033, 4681, 3215031751u, 4294967291u};
+            copy(pseudo.begin(), pseudo.end(), n.begin() + 100);
+
+            batch::isPrime(n.data(), out.data(), COUNT, k);
+            for(size_t i = 0; i < COUNT; i++)
+                REQUIRE((bool)out[i] == isPrime<uint64_t>(n[i]));
+        };
+    }
+}
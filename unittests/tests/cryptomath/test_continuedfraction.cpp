@@ -2,9 +2,15 @@
 #include "../../catch.hpp"
 
 #include "continuedfractions.h"
+#include "cryptomath.h"
+
+#ifdef CRYPTOMATH_GMP
+#include <gmpxx.h>
+#endif
 
 #include <cmath>
 #include <utility>
+#include <algorithm>
 
 #define pi 3.14159265359
 
@@ -135,6 +141,11 @@ TEST_CASE("Fraction to continued fraction")
         - sqrt(0)
         - sqrt(1)
         - sqrt(4)
+        - sqrt(94), which has a period of 16
+        - \f$ \sqrt{2^{62} + 1} \f$ and \f$ \sqrt{2^{62} + 2} \f$, which are past the precision of a double
+        - The denominators \f$ d(k) \f$ of sqrt(61)
+        - \f$ \sqrt{n^2 + 2} \f$ for \f$ n = 2^{100} \f$ with uint256
+        - \f$ \sqrt{10^{40} + 1} \f$ a period of 2174 checked through Pell's equation, and \f$ \sqrt{2^{53} + 1} \f$ matching uint64_t (GMP only)
 */
 TEST_CASE("Continued fractions of simple square roots")
 {
@@ -174,6 +185,75 @@ TEST_CASE("Continued fractions of simple square roots")
 
         REQUIRE(result == (vector<uint64_t>{2}));
     };
+
+    SECTION("sqrt(94) to continued fraction")
+    {
+        result = sqrttocf(94);
+
+        REQUIRE(result == (vector<uint64_t>{9, 1, 2, 3, 1, 1, 5, 1, 8, 1, 5, 1, 1, 3, 2, 1, 18}));
+    };
+
+    SECTION("Values past double precision")
+    {
+        const uint64_t n = 1ull << 31;
+
+        REQUIRE(sqrttocf(n*n + 1) == (vector<uint64_t>{n, 2*n}));
+        REQUIRE(sqrttocf(n*n + 2) == (vector<uint64_t>{n, n, 2*n}));
+        REQUIRE(sqrttocf(n*n - 1) == (vector<uint64_t>{n - 1, 1, 2*n - 2}));
+    };
+
+    SECTION("Streaming the expansion")
+    {
+        sqrt_expansion<int64_t> expansion(61);
+        vector<int64_t> d;
+        for(; !expansion.periodEnd(); ++expansion)
+            d.push_back(expansion.d());
+        d.push_back(expansion.d());
+
+        REQUIRE(expansion.index() == 11);
+        REQUIRE(d == (vector<int64_t>{1, 12, 3, 4, 9, 5, 5, 9, 4, 3, 12, 1}));
+
+        sqrt_expansion<int64_t> square(49);
+        ++square;
+        REQUIRE(square.square());
+        REQUIRE(square.periodEnd());
+        REQUIRE(square.term() == 7);
+    };
+
+    SECTION("Fixed width values")
+    {
+        const cryptomath::uint256 n = cryptomath::uint256(1) << 100;
+
+        REQUIRE(sqrttocf<cryptomath::uint256>(n*n + 2) == (vector<cryptomath::uint256>{n, n, 2*n}));
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mpz_class n("100000000000000000000");
+        REQUIRE(sqrttocf<mpz_class>(n*n + 1) == (vector<mpz_class>{n, 2*n}));
+
+        //The convergent before the end of the period solves x^2 - Dy^2 = +-1
+        const mpz_class D(1000099);
+        vector<mpz_class> cf = sqrttocf<mpz_class>(D);
+        REQUIRE(cf.size() == 2175);
+
+        mpz_class p0 = 1, p1 = cf[0], q0 = 0, q1 = 1;
+        for(size_t i = 1; i + 1 < cf.size(); i++)
+        {
+            mpz_class p2 = cf[i]*p1 + p0, q2 = cf[i]*q1 + q0;
+            p0 = p1; p1 = p2;
+            q0 = q1; q1 = q2;
+        }
+        mpz_class norm = p1*p1 - D*q1*q1;
+        REQUIRE((norm == 1 || norm == -1));
+
+        vector<uint64_t> native = sqrttocf((1ull << 53) + 1);
+        vector<mpz_class> big = sqrttocf<mpz_class>(mpz_class("9007199254740993"));
+        REQUIRE(native.size() == big.size());
+        REQUIRE(equal(native.begin(), native.end(), big.begin(), [](uint64_t a, const mpz_class& b){ return b == a; }));
+    };
+#endif
 }
 
 /*! 
@@ -280,6 +360,68 @@ TEST_CASE("Continued fraction to approximation")
     };
 };
 
+/*!
+    \test Tests generating convergents one at a time
+        - The iterator gives the same convergents as cftof()
+        - Stopping at the first convergent of pi with a denominator over 100
+        - Convergents of sqrt(2) overflow uint8_t and uint64_t, and cftof() throws instead of wrapping
+        - Convergents of sqrt(2) do not overflow uint512 or mpz_class, and solve \f$ x^2 - 2y^2 = \pm 1 \f$ (mpz_class is GMP only)
+*/
+TEST_CASE("Streaming convergents")
+{
+    SECTION("Matches cftof")
+    {
+        vector<uint64_t> cf{3, 7, 15, 1, 292, 1};
+        vector<pair<uint64_t, uint64_t>> result(convergent_iterator<vector<uint64_t>::const_iterator>(cf.cbegin(), cf.cend()),
+                                                convergent_iterator<vector<uint64_t>::const_iterator>(cf.cend(), cf.cend()));
+
+        REQUIRE(result == cftof(cf));
+    };
+
+    SECTION("Stopping early")
+    {
+        vector<uint64_t> cf{3, 7, 15, 1, 292, 1, 1, 1, 2, 1, 3};
+        convergent_iterator<vector<uint64_t>::iterator> iter(cf.begin(), cf.end()), end(cf.end(), cf.end());
+
+        while(iter != end && iter->second <= 100) iter++;
+
+        REQUIRE(iter != end);
+        REQUIRE(*iter == (pair<uint64_t, uint64_t>{333, 106}));
+    };
+
+    SECTION("Overflow")
+    {
+        convergents<uint8_t> small;
+        small.push(1);
+        for(int i = 0; i < 6; i++) small.push(2);
+        REQUIRE(small.value() == (pair<uint8_t, uint8_t>{239, 169}));
+        REQUIRE_THROWS_AS(small.push(2), overflow_error);
+
+        convergents<uint64_t> native;
+        native.push(1);
+        REQUIRE_THROWS_AS([&native]() { while(true) native.push(2); }(), overflow_error);
+        REQUIRE(native.count() > 40);
+
+        REQUIRE_THROWS_AS(cftof(vector<uint64_t>{1, 2}, 100), overflow_error);
+    };
+
+    SECTION("Arbitrary length")
+    {
+        convergents<cryptomath::uint512> fixed;
+        fixed.push(1);
+        for(int i = 0; i < 99; i++) fixed.push(2);
+        REQUIRE(fixed.p()*fixed.p() - 2*fixed.q()*fixed.q() == 1);
+
+#ifdef CRYPTOMATH_GMP
+        convergents<mpz_class> big;
+        big.push(1);
+        for(int i = 0; i < 500; i++) big.push(2);
+        REQUIRE(big.p()*big.p() - 2*big.q()*big.q() == -1);
+        REQUIRE(big.count() == 501);
+#endif
+    };
+}
+
 /*! 
     \test Tests converting continued fractions to real approximation
         - 0
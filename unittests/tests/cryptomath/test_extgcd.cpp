@@ -13,6 +13,12 @@
 using namespace std;
 using namespace cryptomath;
 
+#ifndef DEBUG
+//Native types can be used in constant expressions; debug builds print and cannot
+static_assert(extendedGcd<int64_t>(482, 1180)[0] == 2, "extendedGcd is not constexpr");
+static_assert(extendedGcd<int64_t>(6, 3)[1] == 0 && extendedGcd<int64_t>(6, 3)[2] == 1, "extendedGcd is not constexpr");
+#endif
+
 /*!
     \test Tests that the extended gcd works for a set of cases as well as that it works with the mpz_class type
         - 482, 1180
@@ -199,6 +205,16 @@ TEST_CASE("The extended gcd function")
         REQUIRE(soln[1]*a + soln[2]*b == soln[0]);
     }
 
+    SECTION("Extended GCD(6, 3)")
+    {
+        int a = 6;
+        int b = 3;
+
+        array<int, 3> soln = extendedGcd(a, b);
+
+        REQUIRE(soln == (array<int, 3>{3, 0, 1}));
+    }
+
 #ifdef CRYPTOMATH_GMP    
     SECTION("GMP Support: Extended GCD(482, 1180)")
     {
@@ -26,6 +26,10 @@ using namespace cryptomath;
         - 181
         - 11*13*17*23
         - \f$ 3^5*5*7*13^2*19*37*113 \f$
+
+    Tests that CFRAC can split products of two large primes
+        - 20 digits with uint256
+        - 26 digits with mpz_class (GMP only)
 */
 TEST_CASE("The factoring functions")
 {
@@ -34,7 +38,7 @@ TEST_CASE("The factoring functions")
         vector<uint64_t> nums = {2, 3, 5, 7, 11, 13, 113, 163};
         for(const uint64_t& n : nums)
         {
-            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::PollardP_1; m = (Factor_Method)((int)m+1))
+            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::CFRAC; m = (Factor_Method)((int)m+1))
             {
                 vector<uint64_t> ans = factor(n, m);
                 REQUIRE(ans == vector<uint64_t>{n});
@@ -58,7 +62,7 @@ TEST_CASE("The factoring functions")
         uint64_t i = 0;
         for(const uint64_t& n : nums)
         {
-            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::PollardP_1; m = (Factor_Method)((int)m+1))
+            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::CFRAC; m = (Factor_Method)((int)m+1))
             {
                 vector<uint64_t> ans = factor(n, m);
                 REQUIRE(ans == facs[i]);
@@ -67,6 +71,22 @@ TEST_CASE("The factoring functions")
         }
     };
 
+    SECTION("CFRAC")
+    {
+        uint256 p(5801424313ull), q(8563276121ull);
+        REQUIRE(factor<Factor_Method::CFRAC>(p * q) == (vector<uint256>{p, q}));
+
+        pair<uint256, uint256> split = factoring::cfrac<uint256>(p * q);
+        REQUIRE(split.first * split.second == p * q);
+        REQUIRE(split.first != 1);
+        REQUIRE(split.second != 1);
+
+#ifdef CRYPTOMATH_GMP
+        mpz_class a("8837008927339"), b("1037654655337");
+        REQUIRE(factor<Factor_Method::CFRAC>(mpz_class(a * b)) == (vector<mpz_class>{b, a}));
+#endif
+    };
+
 #ifdef CRYPTOMATH_GMP    
     SECTION("GMP compatible")
     {
@@ -84,7 +104,7 @@ TEST_CASE("The factoring functions")
         uint64_t i = 0;
         for(const mpz_class& n : nums)
         {
-            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::PollardP_1; m = (Factor_Method)((int)m+1))
+            for(Factor_Method m = Factor_Method::Fermat; m <= Factor_Method::CFRAC; m = (Factor_Method)((int)m+1))
             {
                 vector<mpz_class> ans = factor(n, m);
                 REQUIRE(ans == facs[i]);
@@ -93,4 +113,61 @@ TEST_CASE("The factoring functions")
         }
     };
 #endif
-}
\ No newline at end of file
+}
+/*!
+    \test Compares the cost of choosing the primality test and factoring method at runtime and at compile time.
+    Both should take the same time, since the runtime overloads only add a switch.
+    Hidden by default; run with the [benchmark] tag
+        - isPrime with a runtime test, a compile-time test, and the primality test called directly
+        - factor with a runtime method and a compile-time method
+*/
+TEST_CASE("Dispatch overhead", "[.][benchmark]")
+{
+    const uint64_t COUNT = 100000;
+    uint64_t runtime = 0, compiled = 0, direct = 0, count;
+
+    BENCHMARK("isPrime runtime test")
+    {
+        count = 0;
+        for(uint64_t n = 0; n < COUNT; n++)
+            count += isPrime<uint64_t>(n, Primality_Test::MillerRabin);
+        runtime = count;
+    }
+
+    BENCHMARK("isPrime compile-time test")
+    {
+        count = 0;
+        for(uint64_t n = 0; n < COUNT; n++)
+            count += isPrime<Primality_Test::MillerRabin>(n);
+        compiled = count;
+    }
+
+    BENCHMARK("primality::millerRabin")
+    {
+        count = 0;
+        for(uint64_t n = 0; n < COUNT; n++)
+            count += (n == 2 || n == 3) || (n > 3 && n % 2 == 1 && primality::millerRabin<uint64_t>(n, 20));
+        direct = count;
+    }
+
+    REQUIRE(runtime == compiled);
+    REQUIRE(runtime == direct);
+
+    BENCHMARK("factor runtime method")
+    {
+        count = 0;
+        for(uint64_t n = 2; n < COUNT / 10; n++)
+            count += factor<uint64_t>(n, Factor_Method::PollardRho).size();
+        runtime = count;
+    }
+
+    BENCHMARK("factor compile-time method")
+    {
+        count = 0;
+        for(uint64_t n = 2; n < COUNT / 10; n++)
+            count += factor<Factor_Method::PollardRho>(n).size();
+        compiled = count;
+    }
+
+    REQUIRE(runtime == compiled);
+}
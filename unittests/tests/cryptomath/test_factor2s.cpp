@@ -34,12 +34,18 @@ using namespace cryptomath;
             - 186336
             - 1580928
             - 15708
+        - Values using the full width of the type
+            - \f$ 2^{63} \f$ and \f$ 2^{64} - 2 \f$ as uint64_t
+            - \f$ 3*2^{30} \f$ as uint32_t
+            - \f$ 3*2^{100} \f$ as uint128
         
     Tests that the following numbers can have 2's factored out
     with mpz_class type
         - 636416
         - 33554432
         - 32343
+        - 0
+        - \f$ 12345*2^{200} \f$
 */
 TEST_CASE("The factor2s function")
 {
@@ -72,12 +78,22 @@ TEST_CASE("The factor2s function")
         REQUIRE(factor2s(15708) == make_pair(2, 3927));        
     }
 
+    SECTION("Full width values")
+    {
+        REQUIRE(factor2s<uint64_t>(1ull << 63) == make_pair(uint64_t(63), uint64_t(1)));
+        REQUIRE(factor2s<uint64_t>(0xFFFFFFFFFFFFFFFEull) == make_pair(uint64_t(1), uint64_t(0x7FFFFFFFFFFFFFFF)));
+        REQUIRE(factor2s<uint32_t>(3u << 30) == make_pair(uint32_t(30), uint32_t(3)));
+        REQUIRE(factor2s<uint128>(uint128(3) << 100) == make_pair(uint128(100), uint128(3)));
+    };
+
 #ifdef CRYPTOMATH_GMP    
     SECTION("GMP compatible")
     {
         REQUIRE(factor2s(mpz_class(636416)) == make_pair(mpz_class(9), mpz_class(1243)));
         REQUIRE(factor2s(mpz_class(33554432)) == make_pair(mpz_class(25), mpz_class(1)));     
         REQUIRE(factor2s(mpz_class(32343)) == make_pair(mpz_class(0), mpz_class(32343)));        
+        REQUIRE(factor2s(mpz_class(0)) == make_pair(mpz_class(0), mpz_class(0)));
+        REQUIRE(factor2s(mpz_class(mpz_class(12345) << 200)) == make_pair(mpz_class(200), mpz_class(12345)));
     };
 #endif
 }
\ No newline at end of file
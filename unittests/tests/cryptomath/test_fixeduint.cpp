@@ -0,0 +1,191 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "cryptomath.h"
+
+#ifdef CRYPTOMATH_GMP
+#include <gmpxx.h>
+#endif
+
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace cryptomath;
+
+/*!
+    \test Tests the basic arithmetic of the fixed_uint types
+        - Construction from integers and strings
+        - Conversion to decimal strings
+        - Wrap-around on overflow and underflow
+        - Carries between limbs in +, -, *
+        - Division and modulus with single and multiple limb divisors
+        - Shifts across limb boundaries
+
+    Tests that random values give the same results as mpz_class when built with GMP
+*/
+TEST_CASE("The fixed_uint type")
+{
+    const string MAX128 = "340282366920938463463374607431768211455";
+
+    SECTION("Construction")
+    {
+        REQUIRE(uint128().str() == "0");
+        REQUIRE(uint128(12345).str() == "12345");
+        REQUIRE(uint128(-1).str() == MAX128);
+        REQUIRE(uint128(MAX128) == uint128(-1));
+        REQUIRE(uint256("10000000000000000000000000000000000000000").str() == "10000000000000000000000000000000000000000");
+        REQUIRE(uint128(uint256("340282366920938463463374607431768211457")) == 1);
+        REQUIRE((uint64_t)uint128(MAX128) == numeric_limits<uint64_t>::max());
+        REQUIRE_THROWS(uint128("12a"));
+    };
+
+    SECTION("Wrap around")
+    {
+        REQUIRE(uint128(0) - 1 == uint128(MAX128));
+        REQUIRE(uint128(MAX128) + 1 == 0);
+        REQUIRE(-uint128(1) == uint128(MAX128));
+        REQUIRE(numeric_limits<uint128>::max() == uint128(MAX128));
+    };
+
+    SECTION("Carries")
+    {
+        uint128 a = numeric_limits<uint64_t>::max();
+        REQUIRE((a + 1).str() == "18446744073709551616");
+        REQUIRE((a * a).str() == "340282366920938463426481119284349108225");
+        REQUIRE(((a + 1) - 2).str() == "18446744073709551614");
+        REQUIRE((uint256(a + 1) * uint256(a + 1)).str() == "340282366920938463463374607431768211456");
+        REQUIRE((a + 1) * (a + 1) == 0);
+    };
+
+    SECTION("Division")
+    {
+        uint256 a("115792089237316195423570985008687907853269984665640564039457584007913129639935");
+        REQUIRE((a / 10).str() == "11579208923731619542357098500868790785326998466564056403945758400791312963993");
+        REQUIRE(a % 10 == 5);
+        REQUIRE((a / uint256("340282366920938463463374607431768211456")).str() == MAX128);
+        REQUIRE(a % uint256("340282366920938463463374607431768211456") == uint256(MAX128));
+        REQUIRE((a / uint256("12345678901234567890123456789")).str() == "9379159312635045651465904031121901399981084140039");
+        REQUIRE((a % uint256("12345678901234567890123456789")).str() == "9277461260901951535088365164");
+        REQUIRE(uint256(7) / a == 0);
+        REQUIRE(uint256(7) % a == 7);
+        REQUIRE_THROWS(a / 0);
+    };
+
+    SECTION("Shifts")
+    {
+        uint256 one = 1;
+        REQUIRE((one << 200) >> 200 == 1);
+        REQUIRE((one << 64).str() == "18446744073709551616");
+        REQUIRE((one << 256) == 0);
+        REQUIRE(((one << 130) - 1).bitlength() == 130);
+        REQUIRE((one << 130).trailingZeros() == 130);
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mt19937_64 reng(512);
+        mpz_class mod2_512 = mpz_class(1) << 512;
+        for(int i = 0; i < 200; i++)
+        {
+            string sa(1, '1' + reng() % 9), sb(1, '1' + reng() % 9);
+            int la = reng() % 150, lb = reng() % 150;
+            for(int j = 0; j < la; j++) sa += '0' + reng() % 10;
+            for(int j = 0; j < lb; j++) sb += '0' + reng() % 10;
+
+            uint512 a(sa), b(sb);
+            mpz_class ma(sa), mb(sb);
+
+            REQUIRE((a + b).str() == mpz_class((ma + mb) % mod2_512).get_str());
+            REQUIRE((a * b).str() == mpz_class((ma * mb) % mod2_512).get_str());
+            if(ma < mod2_512 && mb < mod2_512)
+            {
+                REQUIRE((a / b).str() == mpz_class(ma / mb).get_str());
+                REQUIRE((a % b).str() == mpz_class(ma % mb).get_str());
+            }
+            if(ma < mod2_512 && mb < mod2_512 && mb > 1)
+            {
+                mpz_class e = ma % 1000000;
+                REQUIRE(powMod<uint512>(a, uint512(e.get_str()), b).str() == powMod<mpz_class>(ma, e, mb).get_str());
+            }
+        }
+    };
+#endif
+}
+
+/*!
+    \test Tests the library functions with the fixed_uint types
+        - mod2, log2, sqrtfloor
+        - powMod with odd and even moduli
+        - gcd
+        - factor2s
+        - jacobi matches the signed calculation, with -1 as \f$ n-1 \f$
+        - isPrime with \f$ 2^{127} - 1 \f$, \f$ 2^{127} + 1 \f$, and a product of two 64-bit primes, with both tests
+*/
+TEST_CASE("Cryptomath with fixed_uint")
+{
+    const uint128 M127 = (uint128(1) << 127) - 1;
+
+    SECTION("Specializations")
+    {
+        REQUIRE(mod2<uint128>(M127) == 1);
+        REQUIRE(mod2<uint128>(M127 - 1) == 0);
+        REQUIRE(log2<uint128>(M127) == 126);
+        REQUIRE(log2<uint256>(uint256(1) << 200) == 200);
+        REQUIRE(sqrtfloor<uint128>(uint128(99)) == 9);
+        REQUIRE(sqrtfloor<uint128>(uint128(100)) == 10);
+        REQUIRE(sqrtfloor<uint256>(uint256(M127) * uint256(M127)) == uint256(M127));
+        REQUIRE(sqrtfloor<uint256>(uint256(M127) * uint256(M127) - 1) == uint256(M127 - 1));
+        REQUIRE(abs<uint128>(M127) == M127);
+    };
+
+    SECTION("PowMod")
+    {
+        REQUIRE(powMod<uint128>(3, 200, 1000) == powMod<uint64_t>(3, 200, 1000));
+        REQUIRE(powMod<uint128>(3, 200, 1001) == powMod<uint64_t>(3, 200, 1001));
+        REQUIRE(powMod<uint128>(5, 0, 7) == 1);
+        REQUIRE(powMod<uint128>(5, 3, 1) == 0);
+        REQUIRE(powMod<uint128>(2, M127 - 1, M127) == 1);
+        REQUIRE(powMod<uint128>(M127 - 1, 2, M127) == 1);
+        REQUIRE(powMod<uint256>(uint256(2), uint256(M127), uint256(M127) + 1) == 0);
+    };
+
+    SECTION("GCD and factor2s")
+    {
+        uint256 p("18446744073709551557"), q("18446744073709551533");
+        REQUIRE(gcd<uint256>(p * q, p * 7) == p);
+        REQUIRE(gcd<uint256>(p, q) == 1);
+        REQUIRE(factor2s<uint256>(p << 100) == make_pair(uint256(100), p));
+    };
+
+    SECTION("Jacobi")
+    {
+        REQUIRE(jacobi<uint128>(3, 7) == 6);
+        REQUIRE(jacobi<uint128>(2, 7) == 1);
+        REQUIRE(jacobi<uint128>(14, 21) == 0);
+        REQUIRE(jacobi<uint128>(5, 1) == 1);
+        for(int64_t n = 3; n < 100; n += 2)
+        {
+            for(int64_t a = 0; a < 2 * n; a++)
+            {
+                int64_t j = jacobi<int64_t>(a, n);
+                REQUIRE(jacobi<uint256>(a, n) == uint256(mod<int64_t>(j, n)));
+            }
+        }
+    };
+
+    SECTION("Primality")
+    {
+        uint128 p("18446744073709551557"), q("18446744073709551533");
+        REQUIRE(isPrime<uint128>(M127));
+        REQUIRE(!isPrime<uint128>(M127 + 2));
+        REQUIRE(isPrime<uint128>(p));
+        REQUIRE(!isPrime<uint128>(p * q));
+        REQUIRE(!isPrime<uint128>(p * q, Primality_Test::SolovayStrassen));
+        REQUIRE(isPrime<uint128>(57719, Primality_Test::SolovayStrassen));
+        REQUIRE(isPrime<uint128>(p, Primality_Test::SolovayStrassen));
+        REQUIRE(isPrime<uint256>(uint256(M127), Primality_Test::SolovayStrassen));
+        REQUIRE(!isPrime<uint256>(uint256(M127) + 2, Primality_Test::SolovayStrassen));
+    };
+}
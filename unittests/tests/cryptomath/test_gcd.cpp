@@ -10,6 +10,12 @@
 using namespace std;
 using namespace cryptomath;
 
+#ifndef DEBUG
+//Native types can be used in constant expressions; debug builds print and cannot
+static_assert(gcd<uint64_t>(12, 18) == 6, "gcd is not constexpr");
+static_assert(gcd<int64_t>(-482, 1180) == 2, "gcd is not constexpr");
+#endif
+
 /*!
     \test Tests edge cases of the GCD.
         - GCD(0, n)
@@ -10,6 +10,11 @@
 using namespace std;
 using namespace cryptomath;
 
+#ifndef DEBUG
+//Native types can be used in constant expressions; debug builds print and cannot
+static_assert(inverseMod<int64_t>(4, 13) == 10, "inverseMod is not constexpr");
+#endif
+
 /*!
     \test Tests finding the inverse of a value mod n
         - 18 mod 8
@@ -7,6 +7,10 @@
 #include <gmpxx.h>
 #endif
 
+#include <random>
+#include <vector>
+#include <iterator>
+
 using namespace std;
 using namespace cryptomath;
 
@@ -24,6 +28,7 @@ using namespace cryptomath;
             - 87699
             - 44175
             - 57725
+        - \f$ 2^{127} - 1 \f$ and \f$ 2^{128} + 1 \f$ (GMP only)
 */
 TEST_CASE("The isPrime function")
 {
@@ -70,7 +75,184 @@ TEST_CASE("The isPrime function")
 
             a = mpz_class(57719);
             REQUIRE(isPrime<mpz_class>(a, m) == true); 
+
+            a = mpz_class("170141183460469231731687303715884105727");
+            REQUIRE(isPrime<mpz_class>(a, m) == true);
+
+            a = mpz_class("340282366920938463463374607431768211457");
+            REQUIRE(isPrime<mpz_class>(a, m) == false);
         }       
     };
 #endif
-}
\ No newline at end of file
+}
+
+/*!
+    \test Tests finding the next prime after a value, with and without GMP
+        - 0, 1, 2
+        - 13
+        - 57713
+        - 89
+        - \f$ 2^{127} - 2 \f$ (GMP only)
+*/
+TEST_CASE("The nextPrime function")
+{
+    SECTION("Small values")
+    {
+        REQUIRE(nextPrime<int64_t>(0) == 2);
+        REQUIRE(nextPrime<int64_t>(1) == 2);
+        REQUIRE(nextPrime<int64_t>(2) == 3);
+        REQUIRE(nextPrime<int64_t>(13) == 17);
+        REQUIRE(nextPrime<int64_t>(57713) == 57719);
+        REQUIRE(nextPrime<int64_t>(89) == 97);
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        REQUIRE(nextPrime<mpz_class>(mpz_class(0)) == 2);
+        REQUIRE(nextPrime<mpz_class>(mpz_class(2)) == 3);
+        REQUIRE(nextPrime<mpz_class>(mpz_class(57713)) == 57719);
+        REQUIRE(nextPrime<mpz_class>(mpz_class("170141183460469231731687303715884105726")) == 
+                mpz_class("170141183460469231731687303715884105727"));
+    };
+#endif
+}
+
+/*!
+    \test Tests testing a whole range of values at once with every batch policy
+        - All values less than 3000 match isPrime()
+        - Random 32-bit values match isPrime()
+        - Products of two primes larger than the trial division limit
+        - Batches which trial division settles entirely, and an empty batch
+        - uint128 values above \f$ 2^{32} \f$, which the SIMD policy hands to isPrime()
+        - \f$ 2^{127} - 1 \f$ and \f$ 2^{128} + 1 \f$ (GMP only)
+*/
+TEST_CASE("The isPrimeBatch function")
+{
+    vector<Batch_Policy> policies{Batch_Policy::Serial, Batch_Policy::Threaded, Batch_Policy::SIMD};
+
+    vector<uint64_t> values;
+    for(uint64_t i = 0; i < 3000; i++)
+        values.push_back(i);
+
+    mt19937_64 reng(29);
+    for(int i = 0; i < 500; i++)
+        values.push_back(reng() >> (32 + reng() % 16));
+
+    values.push_back(257 * 263);
+    values.push_back(65521ull * 65519ull);
+    values.push_back(4294967291ull);
+
+    vector<bool> expected;
+    for(const uint64_t& v : values)
+        expected.push_back(isPrime<uint64_t>(v));
+
+    for(const Batch_Policy& p : policies)
+    {
+        vector<bool> result;
+        isPrimeBatch(values.begin(), values.end(), back_inserter(result), p);
+        REQUIRE(result == expected);
+    }
+
+    SECTION("Values above 32 bits")
+    {
+        const uint128 M61 = (uint128(1) << 61) - 1;
+        vector<uint128> big{M61, M61 + 2, M61 * 4294967291ull, 4294967291ull};
+        for(const Batch_Policy& p : policies)
+        {
+            vector<bool> result;
+            isPrimeBatch(big.begin(), big.end(), back_inserter(result), p);
+            REQUIRE(result == vector<bool>({true, false, false, true}));
+        }
+    };
+
+    SECTION("Settled by trial division")
+    {
+        vector<uint64_t> small{2, 3, 4, 251, 253, 65521, 1ull << 40};
+        for(const Batch_Policy& p : policies)
+        {
+            vector<bool> result;
+            isPrimeBatch(small.begin(), small.end(), back_inserter(result), p);
+            REQUIRE(result == vector<bool>({true, true, false, true, false, true, false}));
+
+            result.clear();
+            isPrimeBatch(small.begin(), small.begin(), back_inserter(result), p);
+            REQUIRE(result.empty());
+        }
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        vector<mpz_class> big{mpz_class(57719), mpz_class(57725),
+                              mpz_class("170141183460469231731687303715884105727"),
+                              mpz_class("340282366920938463463374607431768211457")};
+        for(const Batch_Policy& p : policies)
+        {
+            vector<bool> result;
+            isPrimeBatch(big.begin(), big.end(), back_inserter(result), p);
+            REQUIRE(result == vector<bool>({true, false, true, false}));
+        }
+    };
+#endif
+}
+
+/*!
+    \test Tests the primality tests with a given random generator
+        - The same seed gives the same result for a composite which has many liars
+        - Generators with 32 and 64 bit outputs can be used
+        - Reseeding the default engine makes the tests without a generator reproducible
+        - Primes always pass, and composites with no liars always fail
+*/
+TEST_CASE("Primality tests with a given generator")
+{
+    //2047 = 23 * 89 is a strong pseudoprime to base 2, so one Miller-Rabin round sometimes passes
+    const int64_t PSEUDO = 2047;
+
+    SECTION("Reproducible with a seed")
+    {
+        for(Primality_Test m = Primality_Test::MillerRabin; m <= Primality_Test::SolovayStrassen; m = (Primality_Test)((int)m+1))
+        {
+            vector<bool> first, second;
+            mt19937_64 a(31), b(31);
+            for(int i = 0; i < 200; i++)
+            {
+                first.push_back(isPrime<int64_t>(PSEUDO, m, 1, a));
+                second.push_back(isPrime<int64_t>(PSEUDO, m, 1, b));
+            }
+            REQUIRE(first == second);
+
+            first.clear();
+            second.clear();
+            seedDefaultEngine(31);
+            for(int i = 0; i < 200; i++)
+                first.push_back(isPrime<int64_t>(PSEUDO, m, 1));
+            seedDefaultEngine(31);
+            for(int i = 0; i < 200; i++)
+                second.push_back(isPrime<int64_t>(PSEUDO, m, 1));
+            REQUIRE(first == second);
+        }
+    };
+
+    SECTION("Generator types")
+    {
+        mt19937 r32(1);
+        mt19937_64 r64(1);
+        minstd_rand rmin(1);
+
+        REQUIRE(primality::millerRabin<int64_t>(57719, 20, r32));
+        REQUIRE(primality::solovayStrassen<int64_t>(57719, 20, r64));
+        REQUIRE(isPrime<Primality_Test::MillerRabin>((int64_t)57719, 20, rmin));
+        REQUIRE(!isPrime<Primality_Test::MillerRabin>((int64_t)57725, 20, rmin));
+        REQUIRE(!isPrime<Primality_Test::SolovayStrassen>((int64_t)96083, 20, r32));
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mt19937_64 reng(5);
+        REQUIRE(isPrime<mpz_class>(mpz_class("170141183460469231731687303715884105727"), Primality_Test::MillerRabin, 20, reng));
+        REQUIRE(!isPrime<mpz_class>(mpz_class("340282366920938463463374607431768211457"), Primality_Test::SolovayStrassen, 20, reng));
+    };
+#endif
+}
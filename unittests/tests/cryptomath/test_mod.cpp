@@ -10,6 +10,14 @@
 using namespace std;
 using namespace cryptomath;
 
+#ifndef DEBUG
+//Native types can be used in constant expressions; debug builds print and cannot
+static_assert(mod<int64_t>(-5, 3) == 1, "mod is not constexpr");
+static_assert(powMod<uint64_t>(3, 200, 1001) == 100, "powMod is not constexpr");
+static_assert(jacobi<int64_t>(1001, 9907) == -1, "jacobi is not constexpr");
+static_assert(cryptomath::legendre<int64_t>(5, 11) == 1, "legendre is not constexpr");
+#endif
+
 /*!
     Tests the modulus function and that it can be used with GMP
         - 5 mod 3
@@ -0,0 +1,173 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "cryptomath.h"
+
+#ifdef CRYPTOMATH_GMP
+#include <gmpxx.h>
+#endif
+
+#include <vector>
+#include <utility>
+#include <thread>
+#include <stdexcept>
+
+using namespace std;
+using namespace cryptomath;
+
+/*!
+    \test Tests the fundamental solutions of Pell's equation
+        - D = 2, 3, 61, 109 and D = 5, 13, which have -1 solutions
+        - Every D up to 1000 against the convergent at the end of the first period
+        - D = 991 overflows uint64_t, and is solved with mpz_class (GMP only)
+        - 0 and square values of D throw
+*/
+TEST_CASE("Pell's equation")
+{
+    SECTION("Known solutions")
+    {
+        REQUIRE(solvePell<uint64_t>(2) == (pair<uint64_t, uint64_t>(1, 1)));
+        REQUIRE(solvePell<uint64_t>(3) == (pair<uint64_t, uint64_t>(2, 1)));
+        REQUIRE(solvePell<uint64_t>(5) == (pair<uint64_t, uint64_t>(2, 1)));
+        REQUIRE(solvePell<uint64_t>(13) == (pair<uint64_t, uint64_t>(18, 5)));
+        REQUIRE(solvePell<uint64_t>(61) == (pair<uint64_t, uint64_t>(29718, 3805)));
+        REQUIRE(solvePell<uint64_t>(109) == (pair<uint64_t, uint64_t>(8890182, 851525)));
+    };
+
+    SECTION("Full period")
+    {
+        for(uint64_t D = 2; D <= 1000; D++)
+        {
+            continuedfractions::sqrt_expansion<uint256> expansion(D);
+            if(expansion.square()) continue;
+
+            continuedfractions::convergents<uint256> approximations;
+            approximations.push(expansion.term());
+            for(++expansion; !expansion.periodEnd(); ++expansion)
+                approximations.push(expansion.term());
+
+            pair<uint256, uint256> solution = solvePell<uint256>(D);
+            REQUIRE(solution == approximations.value());
+        }
+    };
+
+    SECTION("Overflow")
+    {
+        REQUIRE_THROWS_AS(solvePell<uint64_t>(991), overflow_error);
+
+#ifdef CRYPTOMATH_GMP
+        pair<mpz_class, mpz_class> solution = solvePell<mpz_class>(991);
+        REQUIRE(solution.first == mpz_class("379516400906811930638014896080"));
+        REQUIRE(solution.second == mpz_class("12055735790331359447442538767"));
+#endif
+    };
+
+    SECTION("Invalid D")
+    {
+        REQUIRE_THROWS_AS(solvePell<uint64_t>(0), domain_error);
+        REQUIRE_THROWS_AS(solvePell<uint64_t>(1), domain_error);
+        REQUIRE_THROWS_AS(solvePell<uint64_t>(144), domain_error);
+    };
+}
+
+/*!
+    \test Tests iterating through the solutions of Pell's equation
+        - D = 2 gives (1, 1), (3, 2), (7, 5), (17, 12), alternating between -1 and +1
+        - D = 3 gives (2, 1), (7, 4), (26, 15), all +1
+        - Every solution satisfies the equation, up to the 12th power for D = 61 with uint512
+        - Stepping past the range of uint64_t throws
+*/
+TEST_CASE("Pell solution iterator")
+{
+    SECTION("Small values")
+    {
+        pell_iterator<int64_t> it(2);
+        vector<pair<int64_t, int64_t>> solutions;
+        vector<int> norms;
+        for(int i = 0; i < 4; i++, ++it)
+        {
+            solutions.push_back(*it);
+            norms.push_back(it.norm());
+        }
+        REQUIRE(solutions == (vector<pair<int64_t, int64_t>>{{1, 1}, {3, 2}, {7, 5}, {17, 12}}));
+        REQUIRE(norms == (vector<int>{-1, 1, -1, 1}));
+
+        pell_iterator<int64_t> other(3);
+        REQUIRE(*other++ == (pair<int64_t, int64_t>(2, 1)));
+        REQUIRE(*other++ == (pair<int64_t, int64_t>(7, 4)));
+        REQUIRE(other.norm() == 1);
+        REQUIRE(other->first == 26);
+        REQUIRE(other.power() == 3);
+    };
+
+    SECTION("Fixed width values")
+    {
+        const uint512 D(61);
+        pell_iterator<uint512> it(D);
+        for(; it.power() <= 12; ++it)
+        {
+            const uint512 x2 = it->first * it->first, dy2 = D * it->second * it->second;
+            if(it.norm() == 1)
+                REQUIRE(x2 - dy2 == 1);
+            else
+                REQUIRE(dy2 - x2 == 1);
+        }
+    };
+
+    SECTION("Overflow")
+    {
+        pell_iterator<uint64_t> it(61);
+        for(int i = 0; i < 3; i++)
+            ++it;
+        REQUIRE(it->first == 6239765965720528801ull);
+        REQUIRE_THROWS_AS(++it, overflow_error);
+    };
+}
+
+#ifdef CRYPTOMATH_GMP
+/*!
+    \test Measures solving Pell's equation for D up to \f$ 10^6 \f$, sampled with a stride of 97, on one thread and
+    across one thread per hardware core. Every solution is checked against the equation.
+    Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("Pell's equation throughput", "[.][benchmark]")
+{
+    const uint64_t LIMIT = 1000000, STRIDE = 97;
+    vector<uint64_t> values;
+    for(uint64_t D = 2; D <= LIMIT; D += STRIDE)
+        if(!intSqrt<uint64_t>(D).first)
+            values.push_back(D);
+
+    vector<pair<mpz_class, mpz_class>> serial(values.size()), parallel(values.size());
+    BENCHMARK("One thread")
+    {
+        for(size_t i = 0; i < values.size(); i++)
+            serial[i] = solvePell<mpz_class>(values[i]);
+    }
+
+    BENCHMARK("All cores")
+    {
+        const uint64_t workers = max<uint64_t>(1, thread::hardware_concurrency());
+        vector<thread> threads;
+        for(uint64_t w = 0; w < workers; w++)
+        {
+            threads.emplace_back([&, w]()
+            {
+                for(size_t i = w; i < values.size(); i += workers)
+                    parallel[i] = solvePell<mpz_class>(values[i]);
+            });
+        }
+        for(thread& t : threads)
+            t.join();
+    }
+
+    REQUIRE(serial == parallel);
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        const mpz_class& x = serial[i].first;
+        const mpz_class& y = serial[i].second;
+        mpz_class norm = x * x - values[i] * y * y;
+        REQUIRE(abs(norm) == 1);
+    }
+}
+#endif
@@ -4,6 +4,8 @@
 #include "bbs.h"
 #include "cryptomath.h"
 
+#include <random>
+
 #ifdef CRYPTOMATH_GMP
 #include <gmpxx.h>
 #endif
@@ -75,4 +77,130 @@ TEST_CASE("The randomPrime function")
         }
     };
 #endif
-}
\ No newline at end of file
+}
+/*! 
+    \test Tests the constrained random prime generators
+        - Blum primes are prime, congruent to 3 mod 4, and in range for 2, 10, 14, and 20 bits
+        - Safe primes \f$ p \f$ have \f$ (p-1)/2 \f$ prime, and are in range for 2, 10, 14, and 20 bits
+        - Less than 2 bits throws
+        - 128 bit Blum and safe primes with mpz_class (GMP only)
+*/
+TEST_CASE("The randomBlumPrime and randomSafePrime functions")
+{
+    typedef mt19937_64 generator;
+    generator reng(33);
+
+    SECTION("Blum primes")
+    {
+        for(uint64_t b : {2, 10, 14, 20})
+        {
+            for(int i=0; i<10; i++)
+            {
+                uint64_t p = randomBlumPrime<uint64_t, generator>(reng, b);
+                REQUIRE(isPrime<uint64_t>(p));
+                REQUIRE(p % 4 == 3);
+                REQUIRE(p > powInt<uint64_t>(2, b));
+                REQUIRE(p < powInt<uint64_t>(2, b+1));
+            }
+        }
+        REQUIRE(randomBlumPrime<uint64_t, generator>(reng, 2) == 7);
+        REQUIRE_THROWS(randomBlumPrime<uint64_t, generator>(reng, 1));
+    };
+
+    SECTION("Safe primes")
+    {
+        for(uint64_t b : {2, 10, 14, 20})
+        {
+            for(int i=0; i<10; i++)
+            {
+                uint64_t p = randomSafePrime<uint64_t, generator>(reng, b);
+                REQUIRE(isPrime<uint64_t>(p));
+                REQUIRE(isPrime<uint64_t>((p - 1) / 2));
+                REQUIRE(p > powInt<uint64_t>(2, b));
+                REQUIRE(p < powInt<uint64_t>(2, b+1));
+            }
+        }
+        REQUIRE(randomSafePrime<uint64_t, generator>(reng, 2) == 7);
+        REQUIRE_THROWS(randomSafePrime<uint64_t, generator>(reng, 0));
+        REQUIRE_THROWS(randomSafePrime<uint64_t, generator>(reng, 63));
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        for(int i=0; i<3; i++)
+        {
+            constexpr uint64_t b = 128;
+            mpz_class p = randomBlumPrime<mpz_class, generator>(reng, b);
+            REQUIRE(isPrime<mpz_class>(p));
+            REQUIRE(p % 4 == 3);
+            REQUIRE(p > powInt<mpz_class>(2, b));
+            REQUIRE(p < powInt<mpz_class>(2, b+1));
+
+            p = randomSafePrime<mpz_class, generator>(reng, b);
+            REQUIRE(isPrime<mpz_class>(p));
+            REQUIRE(isPrime<mpz_class>((p - 1) / 2));
+            REQUIRE(p > powInt<mpz_class>(2, b));
+            REQUIRE(p < powInt<mpz_class>(2, b+1));
+        }
+    };
+#endif
+}
+
+/*! 
+    \test Tests the parallel random prime generator
+        - Results are prime and in range for 10, 20, and 30 bits
+        - The same seed gives the same prime with 1, 2, and 4 workers
+        - Errors from the workers are passed to the caller
+        - 512 bit primes with mpz_class (GMP only)
+*/
+TEST_CASE("The randomPrimeParallel function")
+{
+    SECTION("In range")
+    {
+        mt19937_64 reng(34);
+        for(uint64_t b : {10, 20, 30})
+        {
+            for(int i=0; i<10; i++)
+            {
+                uint64_t p = randomPrimeParallel<uint64_t>(reng, b, 2);
+                REQUIRE(isPrime<uint64_t>(p));
+                REQUIRE(p > powInt<uint64_t>(2, b));
+                REQUIRE(p < powInt<uint64_t>(2, b+1));
+            }
+        }
+    };
+
+    SECTION("Reproducible")
+    {
+        for(int i=0; i<10; i++)
+        {
+            mt19937_64 r1(i), r2(i), r4(i);
+            uint64_t p = randomPrimeParallel<uint64_t>(r1, 30, 1);
+            REQUIRE(randomPrimeParallel<uint64_t>(r2, 30, 2) == p);
+            REQUIRE(randomPrimeParallel<uint64_t>(r4, 30, 4) == p);
+        }
+    };
+
+    SECTION("Errors")
+    {
+        mt19937_64 reng(34);
+        REQUIRE_THROWS(randomPrimeParallel<uint64_t>(reng, 63, 2));
+        REQUIRE_THROWS(randomPrimeParallel<uint64_t>(reng, 40, 2));
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mt19937_64 reng(34);
+        for(int i=0; i<3; i++)
+        {
+            constexpr uint64_t b = 512;
+            mpz_class p = randomPrimeParallel<mpz_class>(reng, b, 4);
+            REQUIRE(isPrime<mpz_class>(p));
+            REQUIRE(p > powInt<mpz_class>(2, b));
+            REQUIRE(p < powInt<mpz_class>(2, b+1));
+        }
+    };
+#endif
+}
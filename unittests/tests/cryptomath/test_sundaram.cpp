@@ -7,6 +7,8 @@
 using namespace std;
 using namespace cryptomath;
 
+static_assert(primeTable<20>().size() == 8 && primeTable<20>()[7] == 19, "primeTable is not constexpr");
+
 /*! 
     \test Tests the sieve of Sundaram for 20 and 1292. GMP is not tested because
     it cannot be used in this function
@@ -43,4 +45,15 @@ TEST_CASE("The Sieve of Sundaram")
         sundaramSieve<int>(1292, answer);
         REQUIRE(answer == soln);       
     };
-}
\ No newline at end of file
+}
+/*!
+    \test Tests that the compile time prime table matches the sieve of Sundaram for 1292
+*/
+TEST_CASE("The compile time prime table")
+{
+    vector<int> answer;
+    sundaramSieve<int>(1292, answer);
+
+    constexpr auto table = primeTable<1292>();
+    REQUIRE(vector<int>(table.begin(), table.end()) == answer);
+}
@@ -0,0 +1,142 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "cryptomath.h"
+
+#ifdef CRYPTOMATH_GMP
+#include <gmpxx.h>
+#endif
+
+#include <vector>
+#include <utility>
+#include <iterator>
+
+using namespace std;
+using namespace cryptomath;
+
+/*!
+    \test Tests Wiener's attack on keys with small and large private exponents
+        - n = 90581, e = 17993, which has d = 5
+        - A 64-bit modulus with d = 10007, and the same modulus with e = 65537 (uint256)
+        - A 1024-bit modulus with a 250-bit d, and the same modulus with e = 65537 (GMP only)
+*/
+TEST_CASE("Wiener's attack")
+{
+    SECTION("Small values")
+    {
+        REQUIRE(attacks::wiener<int64_t>(17993, 90581) == 5);
+        REQUIRE(attacks::wiener<int64_t>(3, 90581) == 0);
+    };
+
+    SECTION("Fixed width values")
+    {
+        const uint256 n("18446743979220271189");
+        REQUIRE(attacks::wiener<uint256>(uint256("10665819987415521903"), n) == 10007);
+        REQUIRE(attacks::wiener<uint256>(uint256(65537), n) == 0);
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mpz_class p = nextPrime<mpz_class>(mpz_class(1) << 511);
+        mpz_class q = nextPrime<mpz_class>(mpz_class(3) << 510);
+        mpz_class n = p * q, phi = (p - 1) * (q - 1);
+
+        mpz_class d = nextPrime<mpz_class>(mpz_class(1) << 250);
+        mpz_class e = inverseMod<mpz_class>(d, phi);
+
+        REQUIRE(attacks::wiener<mpz_class>(e, n) == d);
+        REQUIRE(attacks::wiener<mpz_class>(mpz_class(65537), n) == 0);
+    };
+#endif
+}
+
+/*!
+    \test Tests running Wiener's attack on many keys at once
+        - Keys alternate between vulnerable and not, and the results are in order
+        - The results are the same with 1 and 3 workers, and with more workers than keys
+        - 512-bit moduli (GMP only)
+*/
+TEST_CASE("Wiener's attack on a batch of keys")
+{
+    SECTION("Small values")
+    {
+        vector<pair<int64_t, int64_t>> keys;
+        vector<int64_t> expected;
+        for(int i = 0; i < 20; i++)
+        {
+            keys.emplace_back(17993, 90581);
+            expected.push_back(5);
+            keys.emplace_back(3, 90581);
+            expected.push_back(0);
+        }
+
+        for(uint64_t workers : {1, 3, 64})
+        {
+            vector<int64_t> result;
+            attacks::wienerBatch(keys.begin(), keys.end(), back_inserter(result), workers);
+            REQUIRE(result == expected);
+        }
+    };
+
+#ifdef CRYPTOMATH_GMP
+    SECTION("GMP compatible")
+    {
+        mpz_class p = nextPrime<mpz_class>(mpz_class(1) << 255);
+        mpz_class q = nextPrime<mpz_class>(mpz_class(3) << 254);
+        mpz_class n = p * q, phi = (p - 1) * (q - 1);
+
+        vector<pair<mpz_class, mpz_class>> keys;
+        vector<mpz_class> expected;
+        mpz_class d = mpz_class(1) << 100;
+        for(int i = 0; i < 50; i++)
+        {
+            do d++; while(gcd<mpz_class>(d, phi) != 1);
+            keys.emplace_back(inverseMod<mpz_class>(d, phi), n);
+            expected.push_back(d);
+
+            keys.emplace_back(65537, n);
+            expected.push_back(0);
+        }
+
+        for(uint64_t workers : {1, 3})
+        {
+            vector<mpz_class> result;
+            attacks::wienerBatch(keys.begin(), keys.end(), back_inserter(result), workers);
+            REQUIRE(result == expected);
+        }
+    };
+#endif
+}
+
+#ifdef CRYPTOMATH_GMP
+/*!
+    \test Measures how many 2048-bit keys the batch attack scans per second. None of the keys are vulnerable,
+    so every key is scanned up to the bound of the attack. Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("Wiener's attack throughput", "[.][benchmark]")
+{
+    const int COUNT = 2000;
+    mpz_class p = nextPrime<mpz_class>(mpz_class(1) << 1023);
+    mpz_class q = nextPrime<mpz_class>(mpz_class(3) << 1022);
+    mpz_class n = p * q, phi = (p - 1) * (q - 1);
+
+    vector<pair<mpz_class, mpz_class>> keys;
+    mpz_class d = mpz_class(1) << 1500;
+    while((int)keys.size() < COUNT)
+    {
+        d++;
+        if(gcd<mpz_class>(d, phi) == 1)
+            keys.emplace_back(inverseMod<mpz_class>(d, phi), n);
+    }
+
+    vector<mpz_class> result;
+    BENCHMARK("2000 keys")
+    {
+        result.clear();
+        attacks::wienerBatch(keys.begin(), keys.end(), back_inserter(result));
+    }
+
+    REQUIRE(count(result.begin(), result.end(), mpz_class(0)) == COUNT);
+}
+#endif
@@ -6,6 +6,8 @@
 #include <cmath>
 #include <utility>
 #include <functional>
+#include <stdexcept>
+#include <vector>
 
 using namespace std;
 using namespace des64;
@@ -95,6 +97,53 @@ TEST_CASE("DES64 Internals")
     }
 };
 
+#ifndef DEBUG
+static_assert(permute<32, 48>(0b11110000101010101111000010101010, EXPAND_TABLE) == 0b011110100001010101010101011110100001010101010101,
+              "The expansion lookup tables are built at compile time");
+#endif
+
+/*!
+    \test Tests that the permutation lookup tables give the same results as permuting bit by bit
+        - The initial permutation, its inverse, the expansion, and the C permutation
+        - The key permutation and the choice of \f$ k_i \f$
+*/
+TEST_CASE("DES64 Permutation tables")
+{
+    uint64_t value = 0x0123456789ABCDEF;
+    for(int i = 0; i < 1000; i++)
+    {
+        value = value * 6364136223846793005 + 1442695040888963407;
+        const uint64_t low = value & 0xFFFFFFFF, key = value >> 8;
+
+        REQUIRE(permute<64, 64>(value, IP_TABLE) == permute<64, 64>(value, IP));
+        REQUIRE(permute<64, 64>(value, IP_INV_TABLE) == permute<64, 64>(value, IP_INV));
+        REQUIRE(permute<32, 48>(low, EXPAND_TABLE) == permute<32, 48>(low, EXPAND));
+        REQUIRE(permute<32, 32>(low, C_PERMUTE_TABLE) == permute<32, 32>(low, C_PERMUTE));
+        REQUIRE(permute<64, 56>(value, KEY_PERMUTE_TABLE) == permute<64, 56>(value, KEY_PERMUTE));
+        REQUIRE(permute<56, 48>(key, KEY_CHOOSE_TABLE) == permute<56, 48>(key, KEY_CHOOSE));
+    }
+}
+
+/*!
+    \test Tests that the F function with the combined SP-Boxes matches the F function built from
+    the expansion, the S-Boxes, and the permutation of the C blocks, for many values of ri and ki
+*/
+TEST_CASE("DES64 SP-Boxes")
+{
+    uint64_t value = 0xFEDCBA9876543210;
+    for(int i = 0; i < 1000; i++)
+    {
+        value = value * 6364136223846793005 + 1442695040888963407;
+        const uint64_t ri = value >> 32, ki = (value * 0x9E3779B97F4A7C15) >> 16;
+
+        uint64_t expanded = permute<32, 48>(ri, EXPAND) ^ ki, C = 0;
+        for(int b = 7; b >= 0; b--, expanded >>= 6)
+            C |= (uint64_t)S_BOXES[b][expanded & 0x3F] << (4 * (7-b));
+
+        REQUIRE(F(ri, ki) == permute<32, 32>(C, C_PERMUTE));
+    }
+}
+
 /*!
     \test Tests a specific encryption with the full DES
 */
@@ -115,4 +164,86 @@ TEST_CASE("DES64 Decrypt")
     {
         REQUIRE(decrypt(0x85E813540F0AB405, 0x133457799BBCDFF1) == 0x0123456789ABCDEF);  
     }
-}
\ No newline at end of file
+}
+
+/*!
+    \test Tests encrypting and decrypting with a precomputed key schedule
+        - The schedule holds the same round keys as make_keys
+        - Encrypting and decrypting with the schedule matches the given test case
+        - A buffer of blocks encrypts the same with the schedule and with the key
+        - A key which fails the parity check throws when the schedule is built
+*/
+TEST_CASE("DES64 Key schedule")
+{
+    const uint64_t key = 0x133457799BBCDFF1;
+    const key_schedule schedule(key);
+
+    SECTION("Round keys")
+    {
+        REQUIRE(schedule.keys() == make_keys(key));
+        REQUIRE(schedule[0] == 0b000110110000001011101111111111000111000001110010);
+        REQUIRE(schedule[15] == 0b110010110011110110001011000011100001011111110101);
+    }
+
+    SECTION("Given test case")
+    {
+        REQUIRE(encrypt(0x0123456789ABCDEF, schedule) == 0x85E813540F0AB405);
+        REQUIRE(decrypt(0x85E813540F0AB405, schedule) == 0x0123456789ABCDEF);
+    }
+
+    SECTION("Many blocks")
+    {
+        for(uint64_t block = 0; block < 1000; block++)
+        {
+            uint64_t cipher = encrypt(block * 0x9E3779B97F4A7C15, schedule);
+            REQUIRE(cipher == encrypt(block * 0x9E3779B97F4A7C15, key));
+            REQUIRE(decrypt(cipher, schedule) == block * 0x9E3779B97F4A7C15);
+        }
+    }
+
+    SECTION("Parity")
+    {
+        REQUIRE_THROWS_AS(key_schedule(0), logic_error);
+    }
+}
+
+/*!
+    \test Tests triple DES
+        - Three-key EDE matches the example of NIST SP 800-67, and composing single DES
+        - Two-key EDE uses the first key for the third stage
+        - Using one key for every stage is the same as single DES
+*/
+TEST_CASE("DES64 Triple")
+{
+    const uint64_t k1 = 0x0123456789ABCDEF, k2 = 0x23456789ABCDEF01, k3 = 0x456789ABCDEF0123;
+
+    SECTION("Three keys")
+    {
+        const triple_key_schedule schedule(k1, k2, k3);
+        const vector<uint64_t> plain = {0x5468652071756663, 0x6B2062726F776E20, 0x666F78206A756D70};
+        const vector<uint64_t> cipher = {0xA826FD8CE53B855F, 0xCCE21C8112256FE6, 0x68D5C05DD9B6B900};
+
+        for(size_t i = 0; i < plain.size(); i++)
+        {
+            REQUIRE(encrypt(plain[i], schedule) == cipher[i]);
+            REQUIRE(encrypt(decrypt(encrypt(plain[i], k1), k2), k3) == cipher[i]);
+            REQUIRE(decrypt(cipher[i], schedule) == plain[i]);
+        }
+    }
+
+    SECTION("Two keys")
+    {
+        const triple_key_schedule two(k1, k2), three(k1, k2, k1);
+        for(uint64_t block = 0; block < 100; block++)
+        {
+            REQUIRE(encrypt(block, two) == encrypt(block, three));
+            REQUIRE(decrypt(encrypt(block, two), two) == block);
+        }
+    }
+
+    SECTION("Single DES")
+    {
+        REQUIRE(encrypt(0x0123456789ABCDEF, triple_key_schedule(0x133457799BBCDFF1, 0x133457799BBCDFF1)) == 0x85E813540F0AB405);
+        REQUIRE_THROWS_AS(triple_key_schedule(k1, 0), logic_error);
+    }
+}
@@ -0,0 +1,163 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "des64_bitslice.h"
+
+#include <vector>
+#include <stdexcept>
+
+using namespace std;
+using namespace des64;
+
+/*!
+    \test Tests the internals of the bitsliced DES
+        - Transposing values into bit planes and back
+        - Round key planes from the bits of a key match the key schedule
+*/
+TEST_CASE("DES64 Bitslice Internals")
+{
+    SECTION("Transpose")
+    {
+        _internal::planes m, original;
+        uint64_t value = 0x0123456789ABCDEF;
+        for(uint64_t& v : m)
+            v = value = value * 6364136223846793005 + 1442695040888963407;
+        original = m;
+
+        _internal::transpose(m);
+        for(int k = 0; k < 64; k++)
+            for(int i = 0; i < 64; i++)
+                REQUIRE(((m[k] >> (63 - i)) & 1) == ((original[i] >> (63 - k)) & 1));
+
+        _internal::transpose(m);
+        REQUIRE(m == original);
+    }
+
+    SECTION("Key planes")
+    {
+        const uint64_t key = 0x133457799BBCDFF1;
+        _internal::planes keys;
+        keys.fill(key);
+        _internal::transpose(keys);
+
+        REQUIRE(_internal::key_planes(keys) == _internal::broadcast_key_planes(key_schedule(key)));
+    }
+}
+
+/*!
+    \test Tests encrypting many blocks with one key schedule
+        - The given test case
+        - Counts which are not a multiple of 64 match des64::encrypt
+        - Decrypting in place returns the original blocks
+*/
+TEST_CASE("DES64 Bitslice Blocks")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+
+    SECTION("Given test case")
+    {
+        uint64_t block = 0x0123456789ABCDEF, out;
+        bitslice::encrypt(&block, &out, 1, schedule);
+        REQUIRE(out == 0x85E813540F0AB405);
+
+        bitslice::decrypt(&out, &block, 1, schedule);
+        REQUIRE(block == 0x0123456789ABCDEF);
+    }
+
+    SECTION("Many blocks")
+    {
+        for(size_t count : {0, 1, 63, 64, 65, 200})
+        {
+            vector<uint64_t> blocks(count), out(count);
+            for(size_t i = 0; i < count; i++)
+                blocks[i] = i * 0x9E3779B97F4A7C15;
+
+            bitslice::encrypt(blocks.data(), out.data(), count, schedule);
+            for(size_t i = 0; i < count; i++)
+                REQUIRE(out[i] == encrypt(blocks[i], schedule));
+
+            bitslice::decrypt(out.data(), out.data(), count, schedule);
+            REQUIRE(out == blocks);
+        }
+    }
+}
+
+/*!
+    \test Tests encrypting many blocks with triple DES, which matches triple DES one block at a time
+*/
+TEST_CASE("DES64 Bitslice Triple")
+{
+    const triple_key_schedule schedule(0x0123456789ABCDEF, 0x23456789ABCDEF01, 0x456789ABCDEF0123);
+    vector<uint64_t> blocks(130), out(blocks.size());
+    for(size_t i = 0; i < blocks.size(); i++)
+        blocks[i] = i * 0x9E3779B97F4A7C15;
+
+    bitslice::encrypt(blocks.data(), out.data(), blocks.size(), schedule);
+    for(size_t i = 0; i < blocks.size(); i++)
+        REQUIRE(out[i] == encrypt(blocks[i], schedule));
+
+    bitslice::decrypt(out.data(), out.data(), out.size(), schedule);
+    REQUIRE(out == blocks);
+}
+
+/*!
+    \test Tests encrypting one block with many keys
+        - Each result matches des64::encrypt with that key
+        - Decrypting with the same keys returns the block
+        - A key which fails the parity check throws
+*/
+TEST_CASE("DES64 Bitslice Keys")
+{
+    const uint64_t block = 0x0123456789ABCDEF;
+
+    SECTION("Many keys")
+    {
+        vector<uint64_t> keys;
+        for(uint64_t i = 0; keys.size() < 100; i++)
+        {
+            uint64_t key = i * 0x9E3779B97F4A7C15;
+            if(_internal::parity_check(key))
+                keys.push_back(key);
+        }
+
+        vector<uint64_t> out(keys.size()), back(keys.size());
+        bitslice::encrypt(block, keys.data(), out.data(), keys.size());
+        for(size_t i = 0; i < keys.size(); i++)
+        {
+            REQUIRE(out[i] == encrypt(block, keys[i]));
+            bitslice::decrypt(out[i], &keys[i], &back[i], 1);
+            REQUIRE(back[i] == block);
+        }
+    }
+
+    SECTION("Parity")
+    {
+        uint64_t keys[2] = {0x133457799BBCDFF1, 0}, out[2];
+        REQUIRE_THROWS_AS(bitslice::encrypt(block, keys, out, 2), logic_error);
+    }
+}
+
+/*!
+    \test Compares encrypting 64k blocks one at a time with encrypting them with the bitsliced DES.
+    Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("DES64 Bitslice Throughput", "[.][benchmark]")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+    vector<uint64_t> blocks(1 << 16), single(blocks.size()), sliced(blocks.size());
+    for(size_t i = 0; i < blocks.size(); i++)
+        blocks[i] = i * 0x9E3779B97F4A7C15;
+
+    BENCHMARK("One block at a time")
+    {
+        for(size_t i = 0; i < blocks.size(); i++)
+            single[i] = encrypt(blocks[i], schedule);
+    }
+
+    BENCHMARK("Bitsliced")
+    {
+        bitslice::encrypt(blocks.data(), sliced.data(), blocks.size(), schedule);
+    }
+
+    REQUIRE(single == sliced);
+}
@@ -0,0 +1,127 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "des64_meet.h"
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+using namespace des64;
+using namespace des64::search;
+
+namespace
+{
+    //! Encrypts with double DES, first with k1 and then with k2
+    uint64_t double_encrypt(uint64_t block, uint64_t k1, uint64_t k2)
+    {
+        return encrypt(encrypt(block, k1), k2);
+    }
+}
+
+/*!
+    \test Tests the meet-in-the-middle attack on double DES
+        - Both keys are found in ranges around them, whether or not the table fits in one pass
+        - The result does not depend on the number of threads
+        - Less memory means more passes, and the passes cover the range without overflowing over the whole key space
+        - One pair also finds the keys, along with any false matches
+        - No pairs, ranges outside the key space, and too little memory throw
+*/
+TEST_CASE("DES64 Meet in the Middle")
+{
+    const uint64_t k1 = 0x133457799BBCDFF1, k2 = 0x0123456789ABCDEF;
+    const uint64_t i1 = index_of(k1), i2 = index_of(k2);
+    const vector<known_pair> pairs = {
+        {0x0123456789ABCDEF, double_encrypt(0x0123456789ABCDEF, k1, k2)},
+        {0x5468652071756663, double_encrypt(0x5468652071756663, k1, k2)}
+    };
+    const index_range first = {i1 - 3000, i1 + 1001}, second = {i2 - 77, i2 + 5000};
+
+    SECTION("Passes")
+    {
+        REQUIRE(meet_passes(first) == 1);
+        REQUIRE(meet_passes(first, 4001 * MEET_ENTRY_BYTES) == 1);
+        REQUIRE(meet_passes(first, 4000 * MEET_ENTRY_BYTES) == 2);
+        REQUIRE(meet_passes(first, 1000 * MEET_ENTRY_BYTES + 7) == 5);
+        REQUIRE(meet_passes({5, 5}) == 0);
+
+        REQUIRE(meet_pass_range(first, 0, 1000 * MEET_ENTRY_BYTES + 7) == index_range(i1 - 3000, i1 - 2000));
+        REQUIRE(meet_pass_range(first, 4, 1000 * MEET_ENTRY_BYTES + 7) == index_range(i1 + 1000, i1 + 1001));
+        REQUIRE_THROWS_AS(meet_pass_range(first, 5, 1000 * MEET_ENTRY_BYTES + 7), logic_error);
+    }
+
+    SECTION("Passes over the key space")
+    {
+        const index_range all = {0, KEY_SPACE};
+        const uint64_t entries = MEET_MEMORY / MEET_ENTRY_BYTES, passes = meet_passes(all);
+        REQUIRE(passes == KEY_SPACE / entries);
+
+        uint64_t end = 0;
+        for(uint64_t p : {(uint64_t)0, (uint64_t)1, (uint64_t)255, (uint64_t)256, (uint64_t)257, passes / 2, passes - 1})
+        {
+            index_range range = meet_pass_range(all, p);
+            REQUIRE(range.first == p * entries);
+            REQUIRE(range.second == range.first + entries);
+            end = range.second;
+        }
+        REQUIRE(end == KEY_SPACE);
+
+        const index_range odd = {3, KEY_SPACE - 5};
+        const index_range last = meet_pass_range(odd, meet_passes(odd) - 1);
+        REQUIRE(last.first < last.second);
+        REQUIRE(last.second == KEY_SPACE - 5);
+    }
+
+    SECTION("Attack")
+    {
+        for(size_t memory : {MEET_MEMORY, 1000 * MEET_ENTRY_BYTES, 40 * MEET_ENTRY_BYTES + 5})
+        {
+            for(uint64_t workers : {1, 3})
+                REQUIRE(meet_in_the_middle(pairs, first, second, memory, workers) == vector<key_pair>{{k1, k2}});
+        }
+    }
+
+    SECTION("One pair")
+    {
+        vector<key_pair> found = meet_in_the_middle({pairs[0]}, first, second, 500 * MEET_ENTRY_BYTES, 2);
+        REQUIRE(find(found.begin(), found.end(), key_pair(k1, k2)) != found.end());
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_AS(meet_in_the_middle({}, first, second), logic_error);
+        REQUIRE_THROWS_AS(meet_in_the_middle(pairs, {10, 5}, second), logic_error);
+        REQUIRE_THROWS_AS(meet_in_the_middle(pairs, first, {0, KEY_SPACE + 1}), logic_error);
+        REQUIRE_THROWS_AS(meet_in_the_middle(pairs, first, second, MEET_ENTRY_BYTES - 1), logic_error);
+    }
+}
+
+/*!
+    \test Runs the attack over 2^20 first keys and 2^20 second keys on every hardware core, with a table of
+    one pass and of 8 passes. Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("DES64 Meet in the Middle Throughput", "[.][benchmark]")
+{
+    const uint64_t k1 = 0x133457799BBCDFF1, k2 = 0x0123456789ABCDEF;
+    const vector<known_pair> pairs = {
+        {0x0123456789ABCDEF, double_encrypt(0x0123456789ABCDEF, k1, k2)},
+        {0x5468652071756663, double_encrypt(0x5468652071756663, k1, k2)}
+    };
+    const index_range first = {index_of(k1) - 1000, index_of(k1) - 1000 + (1 << 20)};
+    const index_range second = {index_of(k2) - 1000, index_of(k2) - 1000 + (1 << 20)};
+    vector<key_pair> one, eight;
+
+    BENCHMARK("One pass")
+    {
+        one = meet_in_the_middle(pairs, first, second);
+    }
+
+    BENCHMARK("Eight passes")
+    {
+        eight = meet_in_the_middle(pairs, first, second, (1 << 17) * MEET_ENTRY_BYTES);
+    }
+
+    REQUIRE(one == vector<key_pair>{{k1, k2}});
+    REQUIRE(eight == one);
+}
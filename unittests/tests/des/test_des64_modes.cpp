@@ -0,0 +1,259 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "des64_modes.h"
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+using namespace std;
+using namespace des64;
+
+namespace
+{
+    //! Splits a buffer into big-endian blocks
+    vector<uint64_t> blocks(const vector<uint8_t>& buffer)
+    {
+        vector<uint64_t> out;
+        for(size_t i = 0; i < buffer.size(); i += BLOCK_BYTES)
+            out.push_back(load_block(buffer.data() + i));
+        return out;
+    }
+}
+
+/*!
+    \test Tests the modes of operation with the examples of FIPS 81.
+    The key is 0123456789ABCDEF, the IV is 1234567890ABCDEF, and the plaintext is "Now is the time for all "
+        - ECB, CBC, 64-bit CFB and 64-bit OFB match the published ciphertexts
+        - Each mode decrypts back to the plaintext
+*/
+TEST_CASE("DES64 Modes Known Answers")
+{
+    const key_schedule schedule(0x0123456789ABCDEF);
+    const uint64_t iv = 0x1234567890ABCDEF;
+    const string text = "Now is the time for all ";
+    const vector<uint8_t> plain(text.begin(), text.end());
+
+    vector<pair<Mode, vector<uint64_t>>> expected = {
+        {Mode::ECB, {0x3FA40E8A984D4815, 0x6A271787AB8883F9, 0x893D51EC4B563B53}},
+        {Mode::CBC, {0xE5C7CDDE872BF27C, 0x43E934008C389C0F, 0x683788499A7C05F6}},
+        {Mode::CFB, {0xF3096249C7F46E51, 0xA69E839B1A92F784, 0x03467133898EA622}},
+        {Mode::OFB, {0xF3096249C7F46E51, 0x35F24A242EEB3D3F, 0x3D6D5BE3255AF8C3}}
+    };
+
+    for(const auto& test : expected)
+    {
+        vector<uint8_t> cipher(plain.size()), back(plain.size());
+        encrypt(test.first, plain.data(), cipher.data(), plain.size(), schedule, iv);
+        REQUIRE(blocks(cipher) == test.second);
+
+        decrypt(test.first, cipher.data(), back.data(), cipher.size(), schedule, iv);
+        REQUIRE(back == plain);
+    }
+}
+
+/*!
+    \test Tests the modes of operation on longer buffers
+        - Every mode decrypts back to the plaintext, in place and out of place, across several chunks
+        - CFB, OFB and CTR encrypt lengths which are not a multiple of 8, and a shorter prefix encrypts to a prefix
+        - CTR encrypts the counter starting at the IV
+        - ECB and CBC throw on lengths which are not a multiple of 8
+*/
+TEST_CASE("DES64 Modes Round Trip")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+    const uint64_t iv = 0xFFFFFFFFFFFFFFF0;
+
+    vector<uint8_t> plain(8 * 2500 + 5);
+    for(size_t i = 0; i < plain.size(); i++)
+        plain[i] = (uint8_t)(i * 131 + 7);
+
+    SECTION("Whole blocks")
+    {
+        const size_t length = plain.size() - 5;
+        for(Mode mode : {Mode::ECB, Mode::CBC, Mode::CFB, Mode::OFB, Mode::CTR})
+        {
+            vector<uint8_t> cipher(length), back(length);
+            encrypt(mode, plain.data(), cipher.data(), length, schedule, iv);
+            decrypt(mode, cipher.data(), back.data(), length, schedule, iv);
+            REQUIRE(equal(back.begin(), back.end(), plain.begin()));
+
+            vector<uint8_t> inplace(plain.begin(), plain.begin() + length);
+            encrypt(mode, inplace.data(), inplace.data(), length, schedule, iv);
+            REQUIRE(inplace == cipher);
+            decrypt(mode, inplace.data(), inplace.data(), length, schedule, iv);
+            REQUIRE(inplace == back);
+        }
+    }
+
+    SECTION("Partial blocks")
+    {
+        for(Mode mode : {Mode::CFB, Mode::OFB, Mode::CTR})
+        {
+            vector<uint8_t> cipher(plain.size()), prefix(plain.size() - 9), back(plain.size());
+            encrypt(mode, plain.data(), cipher.data(), plain.size(), schedule, iv);
+            encrypt(mode, plain.data(), prefix.data(), prefix.size(), schedule, iv);
+            REQUIRE(equal(prefix.begin(), prefix.end(), cipher.begin()));
+
+            decrypt(mode, cipher.data(), cipher.data(), cipher.size(), schedule, iv);
+            REQUIRE(cipher == plain);
+        }
+    }
+
+    SECTION("Counter")
+    {
+        vector<uint8_t> zeros(8 * 20, 0), cipher(zeros.size());
+        encrypt(Mode::CTR, zeros.data(), cipher.data(), zeros.size(), schedule, iv);
+        for(size_t i = 0; i < 20; i++)
+            REQUIRE(load_block(cipher.data() + 8*i) == encrypt(iv + i, schedule));
+    }
+
+    SECTION("Length")
+    {
+        vector<uint8_t> out(plain.size());
+        REQUIRE_THROWS_AS(encrypt(Mode::ECB, plain.data(), out.data(), 12, schedule), logic_error);
+        REQUIRE_THROWS_AS(decrypt(Mode::CBC, plain.data(), out.data(), 12, schedule, iv), logic_error);
+    }
+}
+
+/*!
+    \test Tests the modes of operation with triple DES
+        - CBC matches chaining triple DES one block at a time
+        - Every mode decrypts back to the plaintext, on one thread and across threads
+*/
+TEST_CASE("DES64 Triple Modes")
+{
+    const triple_key_schedule schedule(0x0123456789ABCDEF, 0x23456789ABCDEF01, 0x456789ABCDEF0123);
+    const uint64_t iv = 0x1234567890ABCDEF;
+
+    vector<uint8_t> plain(PARALLEL_THRESHOLD + 8 * 3);
+    for(size_t i = 0; i < plain.size(); i++)
+        plain[i] = (uint8_t)(i * 131 + 7);
+
+    SECTION("CBC")
+    {
+        vector<uint8_t> cipher(8 * 10);
+        encrypt(Mode::CBC, plain.data(), cipher.data(), cipher.size(), schedule, iv);
+
+        uint64_t last = iv;
+        for(size_t i = 0; i < cipher.size(); i += 8)
+        {
+            last = encrypt(load_block(plain.data() + i) ^ last, schedule);
+            REQUIRE(load_block(cipher.data() + i) == last);
+        }
+    }
+
+    SECTION("Round trip")
+    {
+        for(Mode mode : {Mode::ECB, Mode::CBC, Mode::CFB, Mode::OFB, Mode::CTR})
+        {
+            vector<uint8_t> cipher(plain.size()), back(plain.size());
+            encrypt(mode, plain.data(), cipher.data(), plain.size(), schedule, iv);
+            decrypt(mode, cipher.data(), back.data(), cipher.size(), schedule, iv);
+            REQUIRE(back == plain);
+
+            decrypt_parallel(mode, cipher.data(), back.data(), cipher.size(), schedule, iv, 1 << 18, 4);
+            REQUIRE(back == plain);
+        }
+    }
+}
+
+/*!
+    \test Tests PKCS#7 padding
+        - Lengths 0 to 16 pad to the next multiple of 8, with between 1 and 8 bytes of padding
+        - Unpadding returns the original length
+        - Invalid padding bytes and lengths throw
+*/
+TEST_CASE("DES64 PKCS7")
+{
+    SECTION("Pad and unpad")
+    {
+        for(size_t length = 0; length <= 16; length++)
+        {
+            vector<uint8_t> buffer(pkcs7_length(length), 0xAA);
+            REQUIRE(buffer.size() % 8 == 0);
+            REQUIRE(buffer.size() > length);
+            REQUIRE(buffer.size() <= length + 8);
+
+            REQUIRE(pkcs7_pad(buffer.data(), length) == buffer.size());
+            REQUIRE(buffer.back() == buffer.size() - length);
+            REQUIRE(pkcs7_unpad(buffer.data(), buffer.size()) == length);
+        }
+    }
+
+    SECTION("Invalid")
+    {
+        vector<uint8_t> buffer = {1, 2, 3, 4, 5, 3, 2, 3};
+        REQUIRE_THROWS_AS(pkcs7_unpad(buffer.data(), buffer.size()), logic_error);
+
+        buffer.back() = 0;
+        REQUIRE_THROWS_AS(pkcs7_unpad(buffer.data(), buffer.size()), logic_error);
+
+        buffer.back() = 9;
+        REQUIRE_THROWS_AS(pkcs7_unpad(buffer.data(), buffer.size()), logic_error);
+
+        buffer.back() = 1;
+        REQUIRE(pkcs7_unpad(buffer.data(), buffer.size()) == 7);
+        REQUIRE_THROWS_AS(pkcs7_unpad(buffer.data(), 7), logic_error);
+    }
+}
+
+/*!
+    \test Tests encrypting and decrypting large buffers across threads
+        - CTR and ECB, and CBC and CFB decryption, match the single threaded modes for 1, 3 and 8 workers
+        - A chunk size which is not a multiple of 8 is rounded down
+        - Decrypting in place matches decrypting out of place
+        - CBC encryption falls back to the single threaded mode
+*/
+TEST_CASE("DES64 Parallel Modes")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+    const uint64_t iv = 0x0123456789ABCDEF;
+
+    vector<uint8_t> plain(PARALLEL_THRESHOLD + 8 * 1000);
+    for(size_t i = 0; i < plain.size(); i++)
+        plain[i] = (uint8_t)(i * 131 + 7);
+
+    for(Mode mode : {Mode::ECB, Mode::CBC, Mode::CFB, Mode::CTR})
+    {
+        vector<uint8_t> serial(plain.size());
+        encrypt(mode, plain.data(), serial.data(), plain.size(), schedule, iv);
+
+        for(uint64_t workers : {1, 3, 8})
+        {
+            vector<uint8_t> cipher(plain.size());
+            encrypt_parallel(mode, plain.data(), cipher.data(), plain.size(), schedule, iv, 100003, workers);
+            REQUIRE(cipher == serial);
+
+            vector<uint8_t> back(plain.size());
+            decrypt_parallel(mode, cipher.data(), back.data(), cipher.size(), schedule, iv, 100003, workers);
+            REQUIRE(back == plain);
+
+            decrypt_parallel(mode, cipher.data(), cipher.data(), cipher.size(), schedule, iv, 65536, workers);
+            REQUIRE(cipher == plain);
+        }
+    }
+}
+
+/*!
+    \test Compares CTR encryption of 16MB on one thread and on one thread per hardware core.
+    Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("DES64 Parallel Throughput", "[.][benchmark]")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+    vector<uint8_t> plain(16 << 20, 0x5A), serial(plain.size()), parallel(plain.size());
+
+    BENCHMARK("CTR one thread")
+    {
+        encrypt(Mode::CTR, plain.data(), serial.data(), plain.size(), schedule);
+    }
+
+    BENCHMARK("CTR all cores")
+    {
+        encrypt_parallel(Mode::CTR, plain.data(), parallel.data(), plain.size(), schedule);
+    }
+
+    REQUIRE(serial == parallel);
+}
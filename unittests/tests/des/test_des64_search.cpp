@@ -0,0 +1,144 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "des64_search.h"
+
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace des64;
+using namespace des64::search;
+
+static_assert(key_at(index_of(0x133457799BBCDFF1)) == 0x133457799BBCDFF1, "key_at and index_of do not match");
+
+/*!
+    \test Tests mapping search indices to keys
+        - Every key passes the parity check, and maps back to its index
+        - Consecutive indices give distinct keys
+*/
+TEST_CASE("DES64 Search Indices")
+{
+    uint64_t index = 0;
+    for(int i = 0; i < 10000; i++, index = (index * 6364136223846793005 + 1442695040888963407) % KEY_SPACE)
+    {
+        uint64_t key = key_at(index);
+        REQUIRE(_internal::parity_check(key));
+        REQUIRE(index_of(key) == index);
+        REQUIRE(key_at(index + 1) != key);
+    }
+
+    REQUIRE(key_at(0) == 0x0101010101010101);
+    REQUIRE(key_at(KEY_SPACE - 1) == 0xFEFEFEFEFEFEFEFE);
+}
+
+/*!
+    \test Tests searching for a key with known plaintexts
+        - The bitsliced match finds exactly the lanes with the key
+        - The indices of a mask with several lanes set are those in range, in increasing order
+        - A range around the key finds it, for ranges which do not start on a multiple of 64
+        - Stopping, saving a checkpoint as text and resuming finds the same key
+        - A second pair rules out a key which only matches the first
+        - An empty list of pairs and a range outside the key space throw
+*/
+TEST_CASE("DES64 Key Search")
+{
+    const uint64_t key = 0x133457799BBCDFF1, index = index_of(key);
+    const vector<known_pair> pairs = {{0x0123456789ABCDEF, 0x85E813540F0AB405}, {0, encrypt(0, key)}};
+
+    SECTION("Bitsliced match")
+    {
+        _internal::planes keys;
+        for(int i = 0; i < 64; i++)
+            keys[i] = key_at((index & ~63ULL) + i);
+        _internal::transpose(keys);
+
+        uint64_t match = _internal::bitslice_match(pairs[0].first, pairs[0].second, _internal::key_planes(keys));
+        REQUIRE(match == 1ULL << (63 - index % 64));
+    }
+
+    SECTION("Matched lanes")
+    {
+        const uint64_t base = 64 * 1000;
+        const uint64_t match = (1ULL << 63) | (1ULL << 58) | (1ULL << 31) | (1ULL << 2) | 1;
+
+        REQUIRE(_internal::match_indices(match, base, base, base + 64) == vector<uint64_t>({base, base + 5, base + 32, base + 61, base + 63}));
+        REQUIRE(_internal::match_indices(match, base, base + 5, base + 62) == vector<uint64_t>({base + 5, base + 32, base + 61}));
+        REQUIRE(_internal::match_indices(match, base, base + 6, base + 32).empty());
+        REQUIRE(_internal::match_indices(0, base, base, base + 64).empty());
+    }
+
+    SECTION("Whole range")
+    {
+        for(uint64_t workers : {1, 3})
+        {
+            key_search search(pairs, index - 70001, index + 12345);
+            REQUIRE(search.run(KEY_SPACE, workers) == 82346);
+            REQUIRE(search.done());
+            REQUIRE(search.searched() == 82346);
+            REQUIRE(search.keys() == vector<uint64_t>{key});
+        }
+    }
+
+    SECTION("Checkpoint")
+    {
+        key_search first(pairs, index - 100000, index + 100);
+        REQUIRE(first.run(30000, 2) == 30000);
+        REQUIRE(first.next() == index - 70000);
+        REQUIRE(first.keys().empty());
+
+        stringstream saved;
+        saved << first.save();
+        checkpoint state;
+        saved >> state;
+        REQUIRE(!saved.fail());
+
+        key_search resumed(pairs, state);
+        resumed.run(60000, 2);
+        REQUIRE(!resumed.done());
+        resumed.run();
+        REQUIRE(resumed.done());
+        REQUIRE(resumed.keys() == vector<uint64_t>{key});
+
+        saved.str("");
+        saved.clear();
+        saved << resumed.save();
+        saved >> state;
+        REQUIRE(!saved.fail());
+        REQUIRE(state.next == index + 100);
+        REQUIRE(state.keys == vector<uint64_t>{key});
+    }
+
+    SECTION("Filtering")
+    {
+        key_search search({{pairs[0].first, pairs[0].second}, {0, 0}}, index - 64, index + 64);
+        search.run();
+        REQUIRE(search.keys().empty());
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_AS(key_search({}, 0, 100), logic_error);
+        REQUIRE_THROWS_AS(key_search(pairs, 100, 0), logic_error);
+        REQUIRE_THROWS_AS(key_search(pairs, 0, KEY_SPACE + 1), logic_error);
+    }
+}
+
+/*!
+    \test Searches 4M keys on every hardware core and reports the keys per second.
+    Hidden by default; run with the [benchmark] tag
+*/
+TEST_CASE("DES64 Key Search Throughput", "[.][benchmark]")
+{
+    const uint64_t key = 0x133457799BBCDFF1;
+    key_search search({{0x0123456789ABCDEF, encrypt(0x0123456789ABCDEF, key)}}, index_of(key) - (1 << 22) + 1, index_of(key) + 1);
+
+    BENCHMARK("Search 4M keys")
+    {
+        search.run();
+    }
+
+    WARN("Keys per second: " << search.keys_per_second());
+    REQUIRE(search.keys() == vector<uint64_t>{key});
+}
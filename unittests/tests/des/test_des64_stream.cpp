@@ -0,0 +1,168 @@
+/*! @file */
+#include "../../catch.hpp"
+
+#include "des64_stream.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <stdexcept>
+#include <system_error>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace des64;
+
+namespace
+{
+    //! A temporary file which is removed when it goes out of scope
+    struct temp_file
+    {
+        string path;
+
+        temp_file()
+        {
+            char name[] = "/tmp/des64_streamXXXXXX";
+            close(mkstemp(name));
+            path = name;
+        }
+
+        ~temp_file()
+        {
+            remove(path.c_str());
+        }
+
+        void write(const vector<uint8_t>& data) const
+        {
+            FILE* f = fopen(path.c_str(), "wb");
+            fwrite(data.data(), 1, data.size(), f);
+            fclose(f);
+        }
+
+        vector<uint8_t> read() const
+        {
+            vector<uint8_t> data;
+            FILE* f = fopen(path.c_str(), "rb");
+            for(int c = fgetc(f); c != EOF; c = fgetc(f))
+                data.push_back((uint8_t)c);
+            fclose(f);
+            return data;
+        }
+    };
+
+    //! Encrypts a buffer in memory, padding ECB and CBC, for comparing with the streamed result
+    vector<uint8_t> expected(Mode mode, vector<uint8_t> plain, const key_schedule& schedule, const uint64_t& iv)
+    {
+        if(mode == Mode::ECB || mode == Mode::CBC)
+        {
+            size_t length = plain.size();
+            plain.resize(pkcs7_length(length));
+            pkcs7_pad(plain.data(), length);
+        }
+
+        encrypt(mode, plain.data(), plain.data(), plain.size(), schedule, iv);
+        return plain;
+    }
+}
+
+/*!
+    \test Tests encrypting files through memory maps
+        - Every mode matches encrypting the whole buffer at once, for lengths around the chunk size
+        - Decrypting returns the original file, including the empty file
+        - Missing files and invalid padding throw
+*/
+TEST_CASE("DES64 Stream Files")
+{
+    const key_schedule schedule(0x133457799BBCDFF1);
+    const uint64_t iv = 0xFFFFFFFFFFFFFFF0;
+    const size_t chunk = 8 * 100;
+    temp_file plain_file, cipher_file, back_file;
+
+    SECTION("Round trip")
+    {
+        for(size_t length : {(size_t)0, (size_t)5, chunk - 8, chunk, chunk + 3, 5 * chunk + 8})
+        {
+            vector<uint8_t> plain(length);
+            for(size_t i = 0; i < length; i++)
+                plain[i] = (uint8_t)(i * 131 + 7);
+            plain_file.write(plain);
+
+            for(Mode mode : {Mode::ECB, Mode::CBC, Mode::CFB, Mode::OFB, Mode::CTR})
+            {
+                const vector<uint8_t> cipher = expected(mode, plain, schedule, iv);
+                REQUIRE(stream::encrypt(mode, plain_file.path, cipher_file.path, schedule, iv, chunk) == cipher.size());
+                REQUIRE(cipher_file.read() == cipher);
+
+                REQUIRE(stream::decrypt(mode, cipher_file.path, back_file.path, schedule, iv, chunk) == length);
+                REQUIRE(back_file.read() == plain);
+            }
+        }
+    }
+
+    SECTION("Errors")
+    {
+        REQUIRE_THROWS_AS(stream::encrypt(Mode::CTR, "/nonexistent/des64", cipher_file.path, schedule), system_error);
+
+        plain_file.write(vector<uint8_t>(8 * 3, 0x11));
+        REQUIRE_THROWS_AS(stream::decrypt(Mode::ECB, plain_file.path, back_file.path, schedule), logic_error);
+
+        plain_file.write(vector<uint8_t>(8 * 3 + 1, 0x11));
+        REQUIRE_THROWS_AS(stream::decrypt(Mode::CBC, plain_file.path, back_file.path, schedule, iv, chunk), logic_error);
+    }
+}
+
+/*!
+    \test Tests encrypting from a pipe, which cannot be memory mapped.
+    Small chunks are used so reads return less than was asked for
+        - The ciphertext matches encrypting the file
+        - Decrypting from a pipe returns the plaintext
+*/
+TEST_CASE("DES64 Stream Pipes")
+{
+    const key_schedule schedule(0x0123456789ABCDEF);
+    const uint64_t iv = 0x1234567890ABCDEF;
+    temp_file cipher_file, back_file;
+
+    vector<uint8_t> plain(100000 + 3);
+    for(size_t i = 0; i < plain.size(); i++)
+        plain[i] = (uint8_t)(i * 131 + 7);
+
+    for(Mode mode : {Mode::CBC, Mode::OFB})
+    {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        thread writer([&]()
+        {
+            for(size_t i = 0; i < plain.size(); i += 1000)
+                write(fds[1], plain.data() + i, min<size_t>(1000, plain.size() - i));
+            close(fds[1]);
+        });
+
+        int out = open(cipher_file.path.c_str(), O_WRONLY | O_TRUNC);
+        stream::encrypt(mode, fds[0], out, schedule, iv, 4096);
+        close(out);
+        writer.join();
+        close(fds[0]);
+
+        const vector<uint8_t> cipher = cipher_file.read();
+        REQUIRE(cipher == expected(mode, plain, schedule, iv));
+
+        REQUIRE(pipe(fds) == 0);
+        thread feeder([&]()
+        {
+            write(fds[1], cipher.data(), cipher.size());
+            close(fds[1]);
+        });
+
+        out = open(back_file.path.c_str(), O_WRONLY | O_TRUNC);
+        stream::decrypt(mode, fds[0], out, schedule, iv, 4096);
+        close(out);
+        feeder.join();
+        close(fds[0]);
+
+        REQUIRE(back_file.read() == plain);
+    }
+}